@@ -208,6 +208,11 @@ have_func("rb_sym2str", "ruby.h")
 have_func("rb_to_symbol", "ruby.h")
 have_func("rb_ary_new_from_args", "ruby.h")
 have_func("rb_ary_new_from_values", "ruby.h")
+have_header("ruby/thread.h")
+have_func("rb_thread_call_without_gvl2", "ruby/thread.h")
+have_header("ruby/thread_native.h")
+have_header("ruby/io/buffer.h")
+have_func("rb_io_buffer_new", "ruby/io/buffer.h")
 have_type("enum ruby_value_type", "ruby.h")
 
 checking_for(checking_message("--enable-debug-log option")) do
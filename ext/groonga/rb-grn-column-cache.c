@@ -1,7 +1,7 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /* vim: set sts=4 sw=4 ts=8 noet: */
 /*
-  Copyright (C) 2018-2021  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2018-2025  Sutou Kouhei <kou@clear-code.com>
 
   This library is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
@@ -186,6 +186,251 @@ rb_grn_column_cache_array_reference (VALUE self, VALUE rb_id)
                         self);
 }
 
+#if RB_GRN_SUPPORT_IO_BUFFER
+typedef struct {
+    VALUE rb_buffer;
+    grn_id first_id;
+} EachBufferData;
+
+static VALUE
+rb_grn_column_cache_each_buffer_yield (VALUE user_data)
+{
+    EachBufferData *data = (EachBufferData *)user_data;
+
+    return rb_yield_values(2, data->rb_buffer, UINT2NUM(data->first_id));
+}
+
+static VALUE
+rb_grn_column_cache_each_buffer_ensure (VALUE user_data)
+{
+    EachBufferData *data = (EachBufferData *)user_data;
+
+    return rb_funcall(data->rb_buffer, rb_intern("free"), 0);
+}
+
+static void
+rb_grn_column_cache_each_buffer_emit (grn_id first_id,
+                                      void *base,
+                                      size_t size)
+{
+    EachBufferData data;
+
+    data.rb_buffer = rb_io_buffer_new(base,
+                                      size,
+                                      RB_IO_BUFFER_EXTERNAL |
+                                      RB_IO_BUFFER_READONLY);
+    data.first_id = first_id;
+    rb_ensure(rb_grn_column_cache_each_buffer_yield, (VALUE)&data,
+              rb_grn_column_cache_each_buffer_ensure, (VALUE)&data);
+}
+
+static grn_id
+rb_grn_column_cache_get_max_id (grn_ctx *context, grn_obj *table)
+{
+    grn_table_cursor *cursor;
+    grn_id max_id = GRN_ID_NIL;
+
+    cursor = grn_table_cursor_open(context, table,
+                                   NULL, 0,
+                                   NULL, 0,
+                                   0, 1,
+                                   GRN_CURSOR_DESCENDING);
+    if (cursor) {
+        max_id = grn_table_cursor_next(context, cursor);
+        grn_table_cursor_close(context, cursor);
+    }
+
+    return max_id;
+}
+#endif
+
+#if RB_GRN_SUPPORT_IO_BUFFER
+typedef struct {
+    VALUE self;
+    RbGrnColumnCache *rb_grn_column_cache;
+    grn_column_cache *segment_holder;
+    grn_id first_id;
+    grn_id last_id;
+} EachBufferScanData;
+
+static VALUE
+rb_grn_column_cache_each_buffer_body (VALUE user_data)
+{
+    EachBufferScanData *data = (EachBufferScanData *)user_data;
+    RbGrnColumnCache *rb_grn_column_cache = data->rb_grn_column_cache;
+    grn_ctx *context = rb_grn_column_cache->context;
+    grn_id id;
+    grn_id chunk_first_id = GRN_ID_NIL;
+    char *chunk_start = NULL;
+    size_t chunk_size = 0;
+
+    for (id = data->first_id;
+         id != GRN_ID_NIL && id <= data->last_id;
+         id++) {
+        char *value;
+        size_t value_size = 0;
+        size_t holder_value_size = 0;
+
+        value = grn_column_cache_ref(context,
+                                     rb_grn_column_cache->column_cache,
+                                     id,
+                                     &value_size);
+        rb_grn_context_check(context, data->self);
+        if (!value) {
+            break;
+        }
+        if (chunk_start && chunk_start + chunk_size == value) {
+            chunk_size += value_size;
+            continue;
+        }
+        if (chunk_start) {
+            /* The column cache has already released the segment of
+             * the chunk but the segment holder still refers it. */
+            rb_grn_column_cache_each_buffer_emit(chunk_first_id,
+                                                 chunk_start,
+                                                 chunk_size);
+            /* The block may close the column cache. */
+            if (!rb_grn_column_cache->column_cache) {
+                return Qnil;
+            }
+        }
+        /* grn_column_cache_ref() releases the current segment when
+         * it moves to the next segment. The segment holder keeps the
+         * segment of the new chunk until the chunk is yielded. */
+        grn_column_cache_ref(context,
+                             data->segment_holder,
+                             id,
+                             &holder_value_size);
+        rb_grn_context_check(context, data->self);
+        chunk_first_id = id;
+        chunk_start = value;
+        chunk_size = value_size;
+    }
+    if (chunk_start) {
+        rb_grn_column_cache_each_buffer_emit(chunk_first_id,
+                                             chunk_start,
+                                             chunk_size);
+    }
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_column_cache_each_buffer_scan_ensure (VALUE user_data)
+{
+    EachBufferScanData *data = (EachBufferScanData *)user_data;
+
+    grn_column_cache_close(data->rb_grn_column_cache->context,
+                           data->segment_holder);
+
+    return Qnil;
+}
+#endif
+
+/*
+ * Yields read-only `IO::Buffer`s that refer column values
+ * directly without copying. Values are stored in Groonga's
+ * memory mapped pages. Values in one page are contiguous but
+ * pages aren't. So the column is split into contiguous chunks
+ * and each chunk is yielded with the record ID of its first
+ * value. The buffer is freed after the block is finished. You
+ * must copy it to use it outside the block.
+ *
+ * Raw values are yielded as is. For example, values of `Time`
+ * column are 64bit integers in microseconds and values of
+ * reference column are 32bit record IDs. Values of deleted
+ * records are also included.
+ *
+ * @example Sum values of Int32 column.
+ *
+ *   sum = 0
+ *   Groonga::ColumnCache.open(Groonga["Users.age"]) do |column_cache|
+ *     column_cache.each_buffer do |buffer, first_id|
+ *       buffer.each(:s32) do |_offset, value|
+ *         sum += value
+ *       end
+ *     end
+ *   end
+ *
+ * @overload each_buffer(first_id=1, last_id=nil) {|buffer, first_id| ...}
+ *   @param first_id [Integer] The first record ID to be yielded.
+ *   @param last_id [Integer, nil] The last record ID to be
+ *     yielded. If this is `nil`, the max record ID of the table
+ *     is used.
+ *
+ *   @yieldparam buffer [IO::Buffer] The read-only view of contiguous
+ *     raw values.
+ *   @yieldparam first_id [Integer] The record ID of the first value
+ *     in `buffer`.
+ *
+ *   @return [void]
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_column_cache_each_buffer (int argc, VALUE *argv, VALUE self)
+{
+#if RB_GRN_SUPPORT_IO_BUFFER
+    RbGrnColumnCache *rb_grn_column_cache;
+    grn_ctx *context;
+    grn_obj *column;
+    VALUE rb_first_id;
+    VALUE rb_last_id;
+    EachBufferScanData data;
+
+    RETURN_ENUMERATOR(self, argc, argv);
+
+    TypedData_Get_Struct(self,
+                         RbGrnColumnCache,
+                         &data_type,
+                         rb_grn_column_cache);
+
+    if (!rb_grn_column_cache->column_cache) {
+        rb_raise(rb_eGrnClosed,
+                 "can't access closed column cache: %" PRIsVALUE,
+                 self);
+    }
+
+    rb_scan_args(argc, argv, "02", &rb_first_id, &rb_last_id);
+
+    context = rb_grn_column_cache->context;
+    data.self = self;
+    data.rb_grn_column_cache = rb_grn_column_cache;
+    if (NIL_P(rb_first_id)) {
+        data.first_id = GRN_ID_NIL + 1;
+    } else {
+        data.first_id = NUM2UINT(rb_first_id);
+    }
+    if (NIL_P(rb_last_id)) {
+        data.last_id =
+            rb_grn_column_cache_get_max_id(context,
+                                           rb_grn_column_cache->table);
+    } else {
+        data.last_id = NUM2UINT(rb_last_id);
+    }
+
+    column = RVAL2GRNCOLUMN(rb_grn_column_cache->rb_column, &context);
+    data.segment_holder = grn_column_cache_open(context, column);
+    if (!data.segment_holder) {
+        rb_grn_context_check(context, self);
+        rb_raise(rb_eGrnError,
+                 "failed to create column cache to hold segments: "
+                 "%" PRIsVALUE,
+                 self);
+    }
+
+    rb_ensure(rb_grn_column_cache_each_buffer_body, (VALUE)&data,
+              rb_grn_column_cache_each_buffer_scan_ensure, (VALUE)&data);
+
+    return Qnil;
+#else
+    rb_raise(rb_eNotImpError,
+             "IO::Buffer isn't available: %" PRIsVALUE,
+             self);
+    return Qnil;
+#endif
+}
+
 /*
  * @overload close
  *   @return [void] Close the column cache.
@@ -233,6 +478,10 @@ rb_grn_init_column_cache (VALUE mGrn)
                      "[]",
                      rb_grn_column_cache_array_reference,
                      1);
+    rb_define_method(rb_cGrnColumnCache,
+                     "each_buffer",
+                     rb_grn_column_cache_each_buffer,
+                     -1);
     rb_define_method(rb_cGrnColumnCache,
                      "close",
                      rb_grn_column_cache_close,
@@ -856,6 +856,228 @@ rb_grn_column_rename (VALUE self, VALUE rb_name)
     return self;
 }
 
+static grn_bool
+rb_grn_column_is_reachable_table (grn_ctx *context,
+                                  grn_obj *source,
+                                  grn_obj *table)
+{
+    grn_obj *current = source;
+
+    while (current != table) {
+        grn_obj *domain;
+
+        if (current->header.type == GRN_TABLE_NO_KEY)
+            return GRN_FALSE;
+        domain = grn_ctx_at(context, current->header.domain);
+        if (!domain || !grn_obj_is_table(context, domain))
+            return GRN_FALSE;
+        current = domain;
+    }
+
+    return GRN_TRUE;
+}
+
+static grn_id
+rb_grn_column_resolve_id (grn_ctx *context,
+                          grn_obj *source,
+                          grn_obj *table,
+                          grn_id id)
+{
+    grn_obj *current = source;
+
+    while (current != table && id != GRN_ID_NIL) {
+        grn_id key_id = GRN_ID_NIL;
+
+        grn_table_get_key(context, current, id, &key_id, sizeof(grn_id));
+        id = key_id;
+        current = grn_ctx_at(context, current->header.domain);
+    }
+
+    return id;
+}
+
+/*
+ * Collects record IDs of @table@ into a binary String of
+ * @grn_id@. @rb_ids@ is @nil@ (all records in @table@), an
+ * Array of IDs, records or keys, or a table whose records
+ * refer to @table@ such as a result of {Groonga::Table#select}.
+ */
+VALUE
+rb_grn_column_collect_ids (grn_ctx *context,
+                           grn_obj *table,
+                           VALUE rb_ids,
+                           VALUE related_object)
+{
+    VALUE rb_packed_ids;
+    grn_id id;
+
+    if (NIL_P(rb_ids) ||
+        RVAL2CBOOL(rb_obj_is_kind_of(rb_ids, rb_cGrnTable))) {
+        grn_obj *source = table;
+        grn_table_cursor *cursor;
+
+        if (!NIL_P(rb_ids)) {
+            source = RVAL2GRNTABLE(rb_ids, &context);
+            if (!rb_grn_column_is_reachable_table(context, source, table)) {
+                rb_raise(rb_eArgError,
+                         "records of the table don't refer to "
+                         "the target table: %" PRIsVALUE
+                         ": %" PRIsVALUE,
+                         rb_ids,
+                         related_object);
+            }
+        }
+
+        rb_packed_ids =
+            rb_str_buf_new(sizeof(grn_id) * grn_table_size(context, source));
+        cursor = grn_table_cursor_open(context, source,
+                                       NULL, 0,
+                                       NULL, 0,
+                                       0, -1,
+                                       GRN_CURSOR_ASCENDING);
+        rb_grn_context_check(context, related_object);
+        while ((id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+            id = rb_grn_column_resolve_id(context, source, table, id);
+            rb_str_cat(rb_packed_ids, (const char *)&id, sizeof(grn_id));
+        }
+        grn_table_cursor_close(context, cursor);
+    } else {
+        long i, n;
+
+        rb_ids = rb_grn_convert_to_array(rb_ids);
+        n = RARRAY_LEN(rb_ids);
+        rb_packed_ids = rb_str_buf_new(sizeof(grn_id) * n);
+        for (i = 0; i < n; i++) {
+            VALUE rb_id = RARRAY_AREF(rb_ids, i);
+
+            if (NIL_P(rb_id)) {
+                id = GRN_ID_NIL;
+            } else if (RB_INTEGER_TYPE_P(rb_id)) {
+                id = NUM2UINT(rb_id);
+            } else {
+                id = RVAL2GRNID(rb_id, context, table, related_object);
+            }
+            rb_str_cat(rb_packed_ids, (const char *)&id, sizeof(grn_id));
+        }
+    }
+
+    return rb_packed_ids;
+}
+
+typedef struct {
+    grn_ctx *context;
+    grn_obj *column;
+    grn_obj *range;
+    grn_column_cache *column_cache;
+    grn_obj value;
+    VALUE rb_packed_ids;
+    VALUE related_object;
+} ValuesAtData;
+
+static VALUE
+rb_grn_column_values_at_body (VALUE user_data)
+{
+    ValuesAtData *data = (ValuesAtData *)user_data;
+    grn_ctx *context = data->context;
+    const grn_id *ids;
+    long i, n_ids;
+    VALUE rb_values;
+
+    ids = (const grn_id *)RSTRING_PTR(data->rb_packed_ids);
+    n_ids = RSTRING_LEN(data->rb_packed_ids) / sizeof(grn_id);
+    rb_values = rb_ary_new_capa(n_ids);
+    for (i = 0; i < n_ids; i++) {
+        grn_id id = ids[i];
+        VALUE rb_value;
+
+        if (id == GRN_ID_NIL) {
+            rb_ary_push(rb_values, Qnil);
+            continue;
+        }
+
+        if (data->column_cache) {
+            void *raw_value;
+            size_t raw_value_size = 0;
+
+            raw_value = grn_column_cache_ref(context,
+                                             data->column_cache,
+                                             id,
+                                             &raw_value_size);
+            GRN_TEXT_SET_REF(&(data->value), raw_value, raw_value_size);
+            rb_value = GRNBULK2RVAL(context,
+                                    &(data->value),
+                                    data->range,
+                                    data->related_object);
+        } else {
+            GRN_BULK_REWIND(&(data->value));
+            grn_obj_get_value(context, data->column, id, &(data->value));
+            rb_grn_context_check(context, data->related_object);
+            rb_value = GRNVALUE2RVAL(context,
+                                     &(data->value),
+                                     data->range,
+                                     data->related_object);
+        }
+        rb_ary_push(rb_values, rb_value);
+    }
+
+    return rb_values;
+}
+
+static VALUE
+rb_grn_column_values_at_ensure (VALUE user_data)
+{
+    ValuesAtData *data = (ValuesAtData *)user_data;
+
+    GRN_OBJ_FIN(data->context, &(data->value));
+    if (data->column_cache)
+        grn_column_cache_close(data->context, data->column_cache);
+
+    return Qnil;
+}
+
+/*
+ * Reads values of @column@ for IDs collected by
+ * rb_grn_column_collect_ids() in one loop. @column@ may be an
+ * accessor. One value buffer is reused for all IDs and
+ * fixed size columns are read through @grn_column_cache@.
+ */
+VALUE
+rb_grn_column_values_at (grn_ctx *context,
+                         grn_obj *column,
+                         VALUE rb_packed_ids,
+                         VALUE related_object)
+{
+    ValuesAtData data;
+    grn_id range_id;
+    VALUE rb_values;
+
+    range_id = grn_obj_get_range(context, column);
+    data.context = context;
+    data.column = column;
+    data.range = grn_ctx_at(context, range_id);
+    data.column_cache = NULL;
+    data.rb_packed_ids = rb_packed_ids;
+    data.related_object = related_object;
+    if (column->header.type == GRN_COLUMN_FIX_SIZE) {
+        data.column_cache = grn_column_cache_open(context, column);
+    }
+    if (data.column_cache) {
+        GRN_VALUE_FIX_SIZE_INIT(&(data.value),
+                                GRN_OBJ_DO_SHALLOW_COPY,
+                                range_id);
+    } else if (grn_obj_is_vector_column(context, column)) {
+        GRN_OBJ_INIT(&(data.value), GRN_VECTOR, 0, range_id);
+    } else {
+        GRN_OBJ_INIT(&(data.value), GRN_BULK, 0, range_id);
+    }
+
+    rb_values = rb_ensure(rb_grn_column_values_at_body, (VALUE)&data,
+                          rb_grn_column_values_at_ensure, (VALUE)&data);
+    RB_GC_GUARD(rb_packed_ids);
+
+    return rb_values;
+}
+
 void
 rb_grn_init_column (VALUE mGrn)
 {
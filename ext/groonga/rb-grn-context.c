@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2010-2021  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2010-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
   Copyright (C) 2019  Horimoto Yasuhiro <horimoto@clear-code.com>
 
@@ -170,7 +170,8 @@ rb_grn_context_fin (RbGrnContext *rb_grn_context)
     rb_grn_context_close_floating_objects(rb_grn_context);
 
     if (context && context->stat != GRN_CTX_FIN && !rb_grn_exited) {
-        if (!(context->flags & GRN_CTX_PER_DB)) {
+        if (!(context->flags & GRN_CTX_PER_DB) &&
+            !rb_grn_context->database_shared) {
             rb_grn_context_unlink_database(context);
         }
         grn_ctx_fin(context);
@@ -248,7 +249,8 @@ rb_grn_context_finalizer (grn_ctx *context, int n_args, grn_obj **grn_objects,
     rb_grn_context = user_data->ptr;
 
     rb_grn_context_close_floating_objects(rb_grn_context);
-    if (!(context->flags & GRN_CTX_PER_DB)) {
+    if (!(context->flags & GRN_CTX_PER_DB) &&
+        !rb_grn_context->database_shared) {
         rb_grn_context_unlink_database(context);
     }
 
@@ -448,10 +450,13 @@ rb_grn_context_s_set_default_options (VALUE self, VALUE options)
 /*
  * Creates a new context.
  *
- * @overload new(encoding: nil)
+ * @overload new(encoding: nil, release_gvl: false)
  *   @param encoding [Groonga::Encoding] The encoding to be used in
  *     the newly created context. See {Groonga::Encoding} how to specify
  *     encoding.
+ *   @param release_gvl [Boolean] Whether heavy operations such as
+ *     {Groonga::Table#select} release the GVL or not. See
+ *     {#release_gvl=} for details.
  *   @return [Groonga::Context] The newly created context.
  */
 static VALUE
@@ -460,26 +465,37 @@ rb_grn_context_initialize (int argc, VALUE *argv, VALUE self)
     VALUE options;
     rb_scan_args(argc, argv, ":", &options);
 
-    static ID keyword_ids[1];
+    static ID keyword_ids[2];
     if (!keyword_ids[0]) {
         CONST_ID(keyword_ids[0], "encoding");
+        CONST_ID(keyword_ids[1], "release_gvl");
     }
-    VALUE kwargs[1];
+    VALUE kwargs[2];
     VALUE rb_encoding = Qundef;
+    VALUE rb_release_gvl = Qundef;
     if (!NIL_P(options)) {
-        rb_get_kwargs(options, keyword_ids, 0, 1, kwargs);
+        rb_get_kwargs(options, keyword_ids, 0, 2, kwargs);
         rb_encoding = kwargs[0];
+        rb_release_gvl = kwargs[1];
     }
-    if (rb_encoding == Qundef) {
+    if (rb_encoding == Qundef || rb_release_gvl == Qundef) {
         VALUE default_options =
             rb_grn_context_s_get_default_options(rb_obj_class(self));
         if (!NIL_P(default_options)) {
-            rb_get_kwargs(default_options, keyword_ids, 0, 1, kwargs);
-            rb_encoding = kwargs[0];
+            rb_get_kwargs(default_options, keyword_ids, 0, 2, kwargs);
+            if (rb_encoding == Qundef) {
+                rb_encoding = kwargs[0];
+            }
+            if (rb_release_gvl == Qundef) {
+                rb_release_gvl = kwargs[1];
+            }
         }
         if (rb_encoding == Qundef) {
             rb_encoding = Qnil;
         }
+        if (rb_release_gvl == Qundef) {
+            rb_release_gvl = Qfalse;
+        }
     }
 
     RbGrnContext *rb_grn_context = ALLOC(RbGrnContext);
@@ -495,6 +511,10 @@ rb_grn_context_initialize (int argc, VALUE *argv, VALUE self)
     GRN_CTX_USER_DATA(context)->ptr = rb_grn_context;
     rb_grn_context->floating_objects = NULL;
     rb_grn_context_reset_floating_objects(rb_grn_context);
+    rb_grn_context->release_gvl = RVAL2CBOOL(rb_release_gvl);
+    rb_grn_context->connected = GRN_FALSE;
+    rb_grn_context->detached = GRN_FALSE;
+    rb_grn_context->database_shared = GRN_FALSE;
     grn_ctx_set_finalizer(context, rb_grn_context_finalizer);
 
     if (!NIL_P(rb_encoding)) {
@@ -629,6 +649,52 @@ rb_grn_context_get_ruby_encoding (VALUE self)
     return rb_grn_encoding_to_ruby_encoding_object(encoding);
 }
 
+/*
+ * @overload release_gvl?
+ *   @return [Boolean] `true` if heavy operations in the context
+ *     release the GVL, `false` otherwise.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_context_release_gvl_p (VALUE self)
+{
+    RbGrnContext *rb_grn_context = RTYPEDDATA_DATA(self);
+
+    return CBOOL2RVAL(rb_grn_context->release_gvl);
+}
+
+/*
+ * Sets whether heavy operations in the context release the GVL or
+ * not.
+ *
+ * If this is `true`, {Groonga::Table#select}, {Groonga::Table#sort},
+ * {Groonga::Table#group} and {Groonga::IndexColumn#search} release
+ * the GVL while Groonga is processing. Other Ruby threads can run in
+ * parallel with them. Ruby's interrupt such as `Thread#raise` and
+ * `Timeout.timeout` cancels the running operation like
+ * {Groonga::RequestCanceler.cancel}. {Groonga::Cancel} is raised for
+ * the canceled operation.
+ *
+ * A context must not be used by multiple threads at the same time
+ * when this is `true`. Use a context for each thread.
+ *
+ * @overload release_gvl=(release_gvl)
+ *   @param release_gvl [Boolean] Whether heavy operations release
+ *     the GVL or not.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_context_set_release_gvl (VALUE self, VALUE rb_release_gvl)
+{
+    RbGrnContext *rb_grn_context = RTYPEDDATA_DATA(self);
+
+    rb_grn_context->release_gvl = RVAL2CBOOL(rb_release_gvl);
+
+    return rb_release_gvl;
+}
+
 /*
  * @overload force_match_escalation?
  *   @return [Bool]
@@ -848,12 +914,132 @@ rb_grn_context_connect (int argc, VALUE *argv, VALUE self)
     rc = grn_ctx_connect(context, host, port, flags);
     rb_grn_context_check(context, self);
     rb_grn_rc_check(rc, self);
+    ((RbGrnContext *)RTYPEDDATA_DATA(self))->connected = GRN_TRUE;
+    rb_iv_set(self, "@connect_options", options);
+
+    return Qnil;
+}
+
+/*
+ * @overload connected?
+ *   @return [Boolean] `true` if the context is connected to a
+ *     groonga server by {#connect}, `false` otherwise.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_context_connected_p (VALUE self)
+{
+    RbGrnContext *rb_grn_context = RTYPEDDATA_DATA(self);
+
+    return CBOOL2RVAL(rb_grn_context->connected);
+}
+
+/*
+ * Detaches the `grn_ctx` inherited from the parent process. The
+ * detached `grn_ctx` isn't finalized and isn't freed. Finalizing it
+ * may touch resources that are still used by the parent process
+ * and freeing it breaks copy-on-write sharing.
+ *
+ * Objects created in the parent process still refer the detached
+ * `grn_ctx`. They aren't finalized or unlinked when they are freed.
+ *
+ * @api private
+ */
+static VALUE
+rb_grn_context_detach_after_fork (VALUE self)
+{
+    RbGrnContext *rb_grn_context = RTYPEDDATA_DATA(self);
+    grn_ctx *context;
+
+    if (!rb_grn_context) {
+        return Qnil;
+    }
+
+    context = rb_grn_context->context;
+    if (context) {
+        GRN_CTX_USER_DATA(context)->ptr = NULL;
+        grn_ctx_set_finalizer(context, NULL);
+    }
+    /* rb_grn_context is leaked intentionally. Objects that are
+     * created in the parent process may still refer it. They check
+     * this flag not to touch the detached grn_ctx. */
+    rb_grn_context->detached = GRN_TRUE;
+    RTYPEDDATA_DATA(self) = NULL;
+
+    return Qnil;
+}
+
+/*
+ * Makes the context use the database opened by other context
+ * without opening it again. It's for worker contexts of
+ * {Groonga::Context#restore_directory}. The database isn't closed
+ * when the context is closed.
+ *
+ * Groonga objects in the database are bound to the context that
+ * opens the database. So the context must be used only for
+ * commands by {#send} and {#receive}.
+ *
+ * @overload use_database_native(database)
+ *   @param database [Groonga::Database] The database to be used.
+ *
+ * @api private
+ */
+static VALUE
+rb_grn_context_use_database_native (VALUE self, VALUE rb_database)
+{
+    RbGrnContext *rb_grn_context = RTYPEDDATA_DATA(self);
+    grn_ctx *context;
+    grn_obj *database;
+
+    context = SELF(self);
+    database = RVAL2GRNOBJECT(rb_database, NULL);
+    grn_ctx_use(context, database);
+    rb_grn_context_check(context, self);
+    rb_grn_context->database_shared = GRN_TRUE;
+
+    return Qnil;
+}
+
+typedef struct {
+    grn_ctx *context;
+    const char *string;
+    unsigned int string_size;
+    int flags;
+    unsigned int query_id;
+} SendData;
+
+static void *
+rb_grn_context_send_without_gvl (void *user_data)
+{
+    SendData *data = user_data;
+
+    data->query_id = grn_ctx_send(data->context,
+                                  data->string,
+                                  data->string_size,
+                                  data->flags);
+
+    return NULL;
+}
+
+static VALUE
+rb_grn_context_send_body (VALUE user_data)
+{
+    SendData *data = (SendData *)user_data;
+
+    rb_grn_context_call_without_gvl(data->context,
+                                    rb_grn_context_send_without_gvl,
+                                    data);
 
     return Qnil;
 }
 
 /*
  * groongaサーバにクエリ文字列を送信する。
+ *
+ * The GVL is released while the query is processed when the context
+ * is created with `release_gvl: true`.
+ *
  * @return [Integer] ID
  * @overload send(string)
  *   @param [String] string クエリ文字列
@@ -862,22 +1048,54 @@ static VALUE
 rb_grn_context_send (VALUE self, VALUE rb_string)
 {
     grn_ctx *context;
-    char *string;
-    unsigned int string_size;
-    int flags = 0;
-    unsigned int query_id;
+    SendData data;
 
     context = SELF(self);
-    string = StringValuePtr(rb_string);
-    string_size = RSTRING_LEN(rb_string);
-    query_id = grn_ctx_send(context, string, string_size, flags);
+    StringValue(rb_string);
+    data.context = context;
+    data.string = RSTRING_PTR(rb_string);
+    data.string_size = RSTRING_LEN(rb_string);
+    data.flags = 0;
+    data.query_id = 0;
+    /* rb_string must not be changed by other threads while the GVL
+     * is released. */
+    rb_str_locktmp(rb_string);
+    rb_ensure(rb_grn_context_send_body, (VALUE)&data,
+              rb_str_unlocktmp, rb_string);
     rb_grn_context_check(context, self);
 
-    return UINT2NUM(query_id);
+    return UINT2NUM(data.query_id);
+}
+
+typedef struct {
+    grn_ctx *context;
+    char *result;
+    unsigned int result_size;
+    int flags;
+    unsigned int query_id;
+} ReceiveData;
+
+static void *
+rb_grn_context_receive_without_gvl (void *user_data)
+{
+    ReceiveData *data = user_data;
+
+    data->query_id = grn_ctx_recv(data->context,
+                                  &(data->result),
+                                  &(data->result_size),
+                                  &(data->flags));
+
+    return NULL;
 }
 
 /*
  * groongaサーバからクエリ実行結果文字列を受信する。
+ *
+ * The GVL is released while waiting for the result when the context
+ * is created with `release_gvl: true`. Other threads can send and
+ * receive with their own contexts while this thread waits for a
+ * response from a groonga server.
+ *
  * @overload receive
  * @return [[ID, String]] クエリ実行結果
  */
@@ -885,16 +1103,22 @@ static VALUE
 rb_grn_context_receive (VALUE self)
 {
     grn_ctx *context;
-    char *result = NULL;
-    unsigned result_size;
+    ReceiveData data;
     VALUE rb_result;
-    int flags = 0;
     unsigned int query_id;
 
     context = SELF(self);
-    query_id = grn_ctx_recv(context, &result, &result_size, &flags);
-    if (result) {
-        rb_result = rb_str_new(result, result_size);
+    data.context = context;
+    data.result = NULL;
+    data.result_size = 0;
+    data.flags = 0;
+    data.query_id = 0;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_context_receive_without_gvl,
+                                    &data);
+    query_id = data.query_id;
+    if (data.result) {
+        rb_result = rb_str_new(data.result, data.result_size);
     } else {
         rb_result = Qnil;
     }
@@ -1056,6 +1280,313 @@ rb_grn_context_object_created (VALUE rb_context, VALUE rb_object)
     rb_funcall(rb_context, id_object_created, 1, rb_object);
 }
 
+#if RB_GRN_SUPPORT_WITHOUT_GVL
+static RB_GRN_THREAD_LOCAL grn_bool rb_grn_context_gvl_released = GRN_FALSE;
+
+typedef struct {
+    void *(*function)(void *data);
+    void *data;
+    void *result;
+    grn_bool called;
+} RbGrnContextWithoutGVLData;
+
+static void *
+rb_grn_context_call_without_gvl_body (void *user_data)
+{
+    RbGrnContextWithoutGVLData *data = user_data;
+
+    rb_grn_context_gvl_released = GRN_TRUE;
+    data->result = data->function(data->data);
+    rb_grn_context_gvl_released = GRN_FALSE;
+    data->called = GRN_TRUE;
+
+    return NULL;
+}
+
+static void
+rb_grn_context_call_without_gvl_cancel (void *user_data)
+{
+    grn_ctx *context = user_data;
+
+    /* This is the same as what Groonga::RequestCanceler.cancel does
+     * for a registered request. Groonga checks it periodically and
+     * stops the current operation. */
+    if (context->rc == GRN_SUCCESS) {
+        context->rc = GRN_CANCEL;
+    }
+}
+
+typedef struct {
+    void *(*function)(void *data);
+    void *data;
+    void *result;
+} RbGrnContextWithGVLData;
+
+static VALUE
+rb_grn_context_call_with_gvl_protected (VALUE user_data)
+{
+    RbGrnContextWithGVLData *data = (RbGrnContextWithGVLData *)user_data;
+
+    data->result = data->function(data->data);
+
+    return Qnil;
+}
+
+static void *
+rb_grn_context_call_with_gvl_body (void *user_data)
+{
+    int state = 0;
+
+    rb_protect(rb_grn_context_call_with_gvl_protected, (VALUE)user_data, &state);
+    if (state != 0) {
+        VALUE exception;
+
+        /* We can't raise an exception while Groonga is running
+         * without the GVL. */
+        exception = rb_errinfo();
+        rb_set_errinfo(Qnil);
+        if (!NIL_P(exception)) {
+            rb_warn("%" PRIsVALUE, exception);
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+/*
+ * Calls `function` without the GVL when the context is created with
+ * `release_gvl: true`. Other Ruby threads can run while `function` is
+ * running. Ruby's interrupt such as `Thread#raise` cancels the
+ * running Groonga operation. `function` must not use any Ruby API.
+ *
+ * `function` is called with the GVL when the context doesn't release
+ * the GVL.
+ */
+void *
+rb_grn_context_call_without_gvl (grn_ctx *context,
+                                 void *(*function)(void *data),
+                                 void *data)
+{
+#if RB_GRN_SUPPORT_WITHOUT_GVL
+    RbGrnContext *rb_grn_context;
+
+    rb_grn_context = GRN_CTX_USER_DATA(context)->ptr;
+    if (!rb_grn_context || !rb_grn_context->release_gvl) {
+        return function(data);
+    }
+
+    return rb_grn_call_without_gvl(context, function, data);
+#else
+    return function(data);
+#endif
+}
+
+/*
+ * Calls `function` without the GVL unconditionally. This is for a
+ * `grn_ctx` that is owned by the caller and isn't shared with other
+ * Ruby threads such as a worker context. See also
+ * rb_grn_context_call_without_gvl().
+ */
+void *
+rb_grn_call_without_gvl (grn_ctx *context,
+                         void *(*function)(void *data),
+                         void *data)
+{
+#if RB_GRN_SUPPORT_WITHOUT_GVL
+    RbGrnContextWithoutGVLData without_gvl_data;
+
+    without_gvl_data.function = function;
+    without_gvl_data.data = data;
+    without_gvl_data.result = NULL;
+    without_gvl_data.called = GRN_FALSE;
+    /* rb_thread_call_without_gvl2() doesn't raise an exception for
+     * pending interrupts. The caller can release Groonga resources
+     * safely. Pending interrupts are processed later. */
+    rb_thread_call_without_gvl2(rb_grn_context_call_without_gvl_body,
+                                &without_gvl_data,
+                                rb_grn_context_call_without_gvl_cancel,
+                                context);
+    if (!without_gvl_data.called) {
+        /* There are pending interrupts. They are processed after
+         * this call. */
+        return function(data);
+    }
+    return without_gvl_data.result;
+#else
+    return function(data);
+#endif
+}
+
+/*
+ * Calls `function` with the GVL. This is for callbacks from Groonga
+ * such as logger that may be called while
+ * rb_grn_context_call_without_gvl() is running. Exceptions raised in
+ * `function` are reported as warnings in the case because they can't
+ * be propagated across Groonga.
+ */
+void *
+rb_grn_context_call_with_gvl (void *(*function)(void *data), void *data)
+{
+#if RB_GRN_SUPPORT_WITHOUT_GVL
+    RbGrnContextWithGVLData with_gvl_data;
+
+    if (!rb_grn_context_gvl_released) {
+        return function(data);
+    }
+
+    with_gvl_data.function = function;
+    with_gvl_data.data = data;
+    with_gvl_data.result = NULL;
+    rb_grn_context_gvl_released = GRN_FALSE;
+    rb_thread_call_with_gvl(rb_grn_context_call_with_gvl_body, &with_gvl_data);
+    rb_grn_context_gvl_released = GRN_TRUE;
+    return with_gvl_data.result;
+#else
+    return function(data);
+#endif
+}
+
+/*
+ * Initializes `n_workers` worker contexts that share the database of
+ * `context`. Each worker runs in its own Ruby thread without the
+ * GVL. rb_grn_worker_pool_fin() must be called for the pool even
+ * when an exception is raised. Use rb_ensure() for it.
+ */
+void
+rb_grn_worker_pool_init (RbGrnWorkerPool *pool,
+                         grn_ctx *context,
+                         long n_workers)
+{
+    long i;
+
+    pool->context = context;
+    pool->workers = NULL;
+    pool->n_workers = 0;
+    pool->rb_threads = Qnil;
+    if (n_workers < 1) {
+        return;
+    }
+
+    pool->workers = ZALLOC_N(RbGrnWorker, n_workers);
+    pool->rb_threads = rb_ary_new_capa(n_workers);
+    for (i = 0; i < n_workers; i++) {
+        RbGrnWorker *worker = &(pool->workers[i]);
+        grn_ctx_init(&(worker->context), 0);
+        grn_ctx_use(&(worker->context), grn_ctx_db(context));
+    }
+    pool->n_workers = n_workers;
+}
+
+grn_ctx *
+rb_grn_worker_pool_get_context (RbGrnWorkerPool *pool, long i)
+{
+    return &(pool->workers[i].context);
+}
+
+static VALUE
+rb_grn_worker_pool_thread (void *user_data)
+{
+    RbGrnWorker *worker = user_data;
+
+    rb_grn_call_without_gvl(&(worker->context),
+                            worker->function,
+                            worker->data);
+
+    return Qnil;
+}
+
+/*
+ * Runs `function` with the `i`-th worker context in a new Ruby
+ * thread. `function` must not use any Ruby API.
+ */
+void
+rb_grn_worker_pool_spawn (RbGrnWorkerPool *pool,
+                          long i,
+                          void *(*function)(void *data),
+                          void *data)
+{
+    RbGrnWorker *worker = &(pool->workers[i]);
+
+    worker->function = function;
+    worker->data = data;
+    rb_ary_push(pool->rb_threads,
+                rb_thread_create(rb_grn_worker_pool_thread, worker));
+}
+
+void
+rb_grn_worker_pool_join (RbGrnWorkerPool *pool)
+{
+    long i, n_threads;
+
+    if (NIL_P(pool->rb_threads)) {
+        return;
+    }
+
+    n_threads = RARRAY_LEN(pool->rb_threads);
+    for (i = 0; i < n_threads; i++) {
+        rb_funcall(RARRAY_AREF(pool->rb_threads, i), rb_intern("join"), 0);
+    }
+}
+
+static VALUE
+rb_grn_worker_pool_join_thread (VALUE rb_thread)
+{
+    return rb_funcall(rb_thread, rb_intern("join"), 0);
+}
+
+/*
+ * Cancels running workers and waits for them. Workers must be
+ * finished before objects that are used by them are freed even
+ * when we're interrupted. Errors in this function are ignored
+ * because this is used in an ensure function.
+ */
+void
+rb_grn_worker_pool_stop (RbGrnWorkerPool *pool)
+{
+    long i, n_threads;
+
+    if (NIL_P(pool->rb_threads)) {
+        return;
+    }
+
+    n_threads = RARRAY_LEN(pool->rb_threads);
+    for (i = 0; i < n_threads; i++) {
+        RbGrnWorker *worker = &(pool->workers[i]);
+        if (worker->context.rc == GRN_SUCCESS) {
+            worker->context.rc = GRN_CANCEL;
+        }
+    }
+    for (i = 0; i < n_threads; i++) {
+        int state = 0;
+        rb_protect(rb_grn_worker_pool_join_thread,
+                   RARRAY_AREF(pool->rb_threads, i),
+                   &state);
+        if (state != 0) {
+            rb_set_errinfo(Qnil);
+        }
+    }
+    pool->rb_threads = Qnil;
+}
+
+/*
+ * Stops workers by rb_grn_worker_pool_stop() and frees worker
+ * contexts.
+ */
+void
+rb_grn_worker_pool_fin (RbGrnWorkerPool *pool)
+{
+    long i;
+
+    rb_grn_worker_pool_stop(pool);
+    for (i = 0; i < pool->n_workers; i++) {
+        grn_ctx_fin(&(pool->workers[i].context));
+    }
+    xfree(pool->workers);
+    pool->workers = NULL;
+    pool->n_workers = 0;
+}
+
 void
 rb_grn_init_context (VALUE mGrn)
 {
@@ -1086,6 +1617,11 @@ rb_grn_init_context (VALUE mGrn)
     rb_define_method(cGrnContext, "ruby_encoding",
                      rb_grn_context_get_ruby_encoding, 0);
 
+    rb_define_method(cGrnContext, "release_gvl?",
+                     rb_grn_context_release_gvl_p, 0);
+    rb_define_method(cGrnContext, "release_gvl=",
+                     rb_grn_context_set_release_gvl, 1);
+
     rb_define_method(cGrnContext, "force_match_escalation?",
                      rb_grn_context_force_match_escalation_p, 0);
     rb_define_method(cGrnContext, "force_match_escalation=",
@@ -1111,6 +1647,11 @@ rb_grn_init_context (VALUE mGrn)
     rb_define_method(cGrnContext, "[]", rb_grn_context_array_reference, 1);
 
     rb_define_method(cGrnContext, "connect", rb_grn_context_connect, -1);
+    rb_define_method(cGrnContext, "connected?", rb_grn_context_connected_p, 0);
+    rb_define_private_method(cGrnContext, "detach_after_fork",
+                             rb_grn_context_detach_after_fork, 0);
+    rb_define_private_method(cGrnContext, "use_database_native",
+                             rb_grn_context_use_database_native, 1);
     rb_define_method(cGrnContext, "send", rb_grn_context_send, 1);
     rb_define_method(cGrnContext, "receive", rb_grn_context_receive, 0);
 
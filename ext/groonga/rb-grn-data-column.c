@@ -245,6 +245,138 @@ rb_grn_data_column_apply_expression (VALUE self)
     return self;
 }
 
+static VALUE
+rb_grn_data_column_packed_values_at (grn_ctx *context,
+                                     grn_obj *column,
+                                     grn_obj *range,
+                                     VALUE rb_packed_ids,
+                                     VALUE self)
+{
+    grn_column_cache *column_cache = NULL;
+    const grn_id *ids;
+    long i, n_ids;
+    size_t value_size;
+    VALUE rb_values;
+
+    if (column->header.type == GRN_COLUMN_FIX_SIZE) {
+        column_cache = grn_column_cache_open(context, column);
+    }
+    if (!column_cache) {
+        rb_raise(rb_eArgError,
+                 "packed values are only supported "
+                 "for fixed size columns: %" PRIsVALUE,
+                 self);
+    }
+
+    if (grn_obj_is_table(context, range)) {
+        value_size = sizeof(grn_id);
+    } else {
+        value_size = grn_obj_get_range(context, range);
+    }
+
+    ids = (const grn_id *)RSTRING_PTR(rb_packed_ids);
+    n_ids = RSTRING_LEN(rb_packed_ids) / sizeof(grn_id);
+    rb_values = rb_str_buf_new(value_size * n_ids);
+    for (i = 0; i < n_ids; i++) {
+        void *raw_value = NULL;
+        size_t raw_value_size = 0;
+
+        if (ids[i] != GRN_ID_NIL) {
+            raw_value = grn_column_cache_ref(context,
+                                             column_cache,
+                                             ids[i],
+                                             &raw_value_size);
+        }
+        if (raw_value && raw_value_size == value_size) {
+            rb_str_cat(rb_values, raw_value, value_size);
+        } else {
+            long offset = RSTRING_LEN(rb_values);
+            rb_str_resize(rb_values, offset + value_size);
+            memset(RSTRING_PTR(rb_values) + offset, 0, value_size);
+        }
+    }
+    grn_column_cache_close(context, column_cache);
+    RB_GC_GUARD(rb_packed_ids);
+
+    return rb_values;
+}
+
+/*
+ * Reads values for many records at once. It's faster than
+ * calling {Groonga::Column#[]} for each record because it
+ * reuses one value buffer in one loop. Values of
+ * {Groonga::FixSizeColumn} are read through
+ * {Groonga::ColumnCache}.
+ *
+ * @example Read values of the given records.
+ *
+ *   ages = Groonga["Users.age"]
+ *   ages.values_at([1, 2, 3]) # -> [29, 41, 18]
+ *
+ * @example Read values of records in a search result.
+ *
+ *   users = Groonga["Users"]
+ *   adults = users.select {|record| record.age >= 20}
+ *   ages.values_at(adults) # -> [29, 41]
+ *
+ * @example Read values as a packed binary string.
+ *
+ *   ages.values_at([1, 2, 3], :packed => true).unpack("L*")
+ *     # -> [29, 41, 18]
+ *
+ * @overload values_at(ids, options={})
+ *   @param ids [::Array<Integer, Groonga::Record, Object>,
+ *     Groonga::Table, nil]
+ *     The records to be read. An element of ::Array is a record
+ *     ID, a {Groonga::Record} or a key of the table of the
+ *     column. {Groonga::Table} must be the table of the column
+ *     or a table whose records refer to it such as a result of
+ *     {Groonga::Table#select}. If this is `nil`, values of all
+ *     records in the table of the column are read.
+ *   @param options [::Hash] The name and value pairs.
+ *   @option options [Boolean] :packed (false)
+ *     If this is `true`, raw values are concatenated into one
+ *     binary string instead of an array. Values for
+ *     nonexistent records are filled with zero. It's only
+ *     available for {Groonga::FixSizeColumn}.
+ *
+ *   @return [::Array<Object>, String] The values in the order of `ids`.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_data_column_values_at (int argc, VALUE *argv, VALUE self)
+{
+    grn_ctx *context;
+    grn_obj *column;
+    grn_obj *table;
+    grn_obj *range;
+    VALUE rb_ids;
+    VALUE rb_options;
+    VALUE rb_packed;
+    VALUE rb_packed_ids;
+
+    rb_scan_args(argc, argv, "11", &rb_ids, &rb_options);
+    rb_grn_scan_options(rb_options,
+                        "packed", &rb_packed,
+                        NULL);
+
+    rb_grn_column_deconstruct(SELF(self), &column, &context,
+                              NULL, &table,
+                              NULL, NULL, &range);
+
+    rb_packed_ids = rb_grn_column_collect_ids(context, table, rb_ids, self);
+    if (RVAL2CBOOL(rb_packed)) {
+        return rb_grn_data_column_packed_values_at(context,
+                                                   column,
+                                                   range,
+                                                   rb_packed_ids,
+                                                   self);
+    } else {
+        return rb_grn_column_values_at(context, column, rb_packed_ids, self);
+    }
+}
+
 /*
  * @overload missing_mode
  * @return [:add, :ignore, :nil] The missing mode of the column.
@@ -429,6 +561,9 @@ rb_grn_init_data_column (VALUE mGrn)
     rb_define_method(rb_cGrnDataColumn, "apply_expression",
                      rb_grn_data_column_apply_expression, 0);
 
+    rb_define_method(rb_cGrnDataColumn, "values_at",
+                     rb_grn_data_column_values_at, -1);
+
     rb_define_method(rb_cGrnDataColumn, "missing_mode",
                      rb_grn_data_column_get_missing_mode, 0);
     rb_define_method(rb_cGrnDataColumn, "missing_add?",
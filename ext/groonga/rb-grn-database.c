@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2021  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
 
   This library is free software; you can redistribute it and/or
@@ -724,6 +724,80 @@ rb_grn_database_reindex (VALUE self)
     return Qnil;
 }
 
+typedef struct {
+    grn_ctx context;
+    grn_id index_id;
+    grn_rc rc;
+} ReindexIndexData;
+
+static void *
+rb_grn_database_reindex_index_without_gvl (void *user_data)
+{
+    ReindexIndexData *data = user_data;
+    grn_ctx *context = &(data->context);
+    grn_obj *index;
+
+    index = grn_ctx_at(context, data->index_id);
+    if (!index) {
+        if (context->rc == GRN_SUCCESS) {
+            context->rc = GRN_INVALID_ARGUMENT;
+            snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                     "[database][reindex] nonexistent index: <%u>",
+                     data->index_id);
+        }
+        return NULL;
+    }
+    data->rc = grn_obj_reindex(context, index);
+    grn_obj_unlink(context, index);
+
+    return NULL;
+}
+
+/*
+ * Recreates the index column by a worker context that shares the
+ * database. It's used by worker threads of
+ * {Groonga::Database#reindex_parallel}. The GVL is always released
+ * because the worker context isn't shared with other threads.
+ *
+ * @api private
+ */
+static VALUE
+rb_grn_database_reindex_index_native (VALUE self, VALUE rb_index_id)
+{
+    grn_ctx *context;
+    grn_obj *database;
+    ReindexIndexData data;
+    grn_rc rc;
+    char message[GRN_CTX_MSGSIZE];
+
+    rb_grn_database_deconstruct(SELF(self), &database, &context,
+                                NULL, NULL, NULL, NULL);
+
+    data.index_id = NUM2UINT(rb_index_id);
+    data.rc = GRN_SUCCESS;
+    grn_ctx_init(&(data.context), 0);
+    grn_ctx_use(&(data.context), database);
+    rb_grn_call_without_gvl(&(data.context),
+                            rb_grn_database_reindex_index_without_gvl,
+                            &data);
+    rc = data.context.rc;
+    if (rc == GRN_SUCCESS) {
+        rc = data.rc;
+    }
+    snprintf(message, GRN_CTX_MSGSIZE, "%s", data.context.errbuf);
+    grn_ctx_fin(&(data.context));
+
+    if (rc != GRN_SUCCESS) {
+        rb_raise(rb_grn_rc_to_exception(rc),
+                 "failed to reindex: <%u>: %s: %" PRIsVALUE,
+                 NUM2UINT(rb_index_id),
+                 message,
+                 self);
+    }
+
+    return Qnil;
+}
+
 /*
  * Removes an object forcibly.
  *
@@ -791,5 +865,7 @@ rb_grn_init_database (VALUE mGrn)
     rb_define_method(rb_cGrnDatabase, "recover", rb_grn_database_recover, 0);
     rb_define_method(rb_cGrnDatabase, "unmap", rb_grn_database_unmap, 0);
     rb_define_method(rb_cGrnDatabase, "reindex", rb_grn_database_reindex, 0);
+    rb_define_private_method(rb_cGrnDatabase, "reindex_index_native",
+                             rb_grn_database_reindex_index_native, 1);
     rb_define_method(rb_cGrnDatabase, "remove_force", rb_grn_database_remove_force, 1);
 }
@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2022  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
   Copyright (C) 2019  Horimoto Yasuhiro <horimoto@clear-code.com>
 
@@ -755,6 +755,27 @@ rb_grn_index_column_set_source (VALUE self, VALUE rb_source)
     return rb_grn_index_column_set_sources(self, rb_source);
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *column;
+    grn_obj *query;
+    grn_obj *result;
+    grn_operator operator;
+    grn_search_optarg *options;
+    grn_rc rc;
+} SearchData;
+
+static void *
+rb_grn_index_column_search_without_gvl (void *user_data)
+{
+    SearchData *data = user_data;
+
+    data->rc = grn_obj_search(data->context, data->column, data->query,
+                              data->result, data->operator, data->options);
+
+    return NULL;
+}
+
 /*
  * _object_ から _query_ に対応するオブジェクトを検索し、見つかっ
  * たオブジェクトのIDがキーになっている {Groonga::Hash} を返す。
@@ -798,6 +819,7 @@ rb_grn_index_column_search (int argc, VALUE *argv, VALUE self)
     grn_search_optarg options;
     grn_rc rc;
     VALUE rb_query, rb_options, rb_result, rb_operator, rb_mode, rb_weight;
+    SearchData data;
 
     rb_grn_index_column_deconstruct(SELF(self), &column, &context,
                                     NULL, NULL,
@@ -854,7 +876,17 @@ rb_grn_index_column_search (int argc, VALUE *argv, VALUE self)
     options.proc = NULL;
     options.max_size = 0;
 
-    rc = grn_obj_search(context, column, query, result, operator, &options);
+    data.context = context;
+    data.column = column;
+    data.query = query;
+    data.result = result;
+    data.operator = operator;
+    data.options = &options;
+    data.rc = GRN_SUCCESS;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_index_column_search_without_gvl,
+                                    &data);
+    rc = data.rc;
     rb_grn_rc_check(rc, self);
 
     return rb_result;
@@ -1329,6 +1361,20 @@ rb_grn_index_column_estimate_size (int argc, VALUE *argv, VALUE self)
     return UINT2NUM(size);
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *column;
+    grn_rc rc;
+} ReindexData;
+
+static void *
+rb_grn_index_column_reindex_without_gvl (void *user_data)
+{
+    ReindexData *data = user_data;
+    data->rc = grn_obj_reindex(data->context, data->column);
+    return NULL;
+}
+
 /*
  * Recreates the index column.
  *
@@ -1377,10 +1423,14 @@ rb_grn_index_column_estimate_size (int argc, VALUE *argv, VALUE self)
  *   #   Groonga["BigramTerms.Memos_content"].reindex
  *   #   Groonga["MeCabTerms.Memos_title"].reindex
  *
+ * The GVL is released while the index column is recreated when the
+ * context is created with `release_gvl: true`.
+ *
  * @overload reindex
  *   @return [void]
  *
  * @see Groonga::Database#reindex
+ * @see Groonga::Database#reindex_parallel
  * @see Groonga::TableKeySupport#reindex
  * @see Groonga::FixSizeColumn#reindex
  * @see Groonga::VariableSizeColumn#reindex
@@ -1390,9 +1440,9 @@ rb_grn_index_column_estimate_size (int argc, VALUE *argv, VALUE self)
 static VALUE
 rb_grn_index_column_reindex (VALUE self)
 {
-    grn_rc rc;
     grn_ctx *context;
     grn_obj *column;
+    ReindexData data;
 
     rb_grn_index_column_deconstruct(SELF(self), &column, &context,
                                     NULL, NULL,
@@ -1400,9 +1450,14 @@ rb_grn_index_column_reindex (VALUE self)
                                     NULL, NULL,
                                     NULL, NULL);
 
-    rc = grn_obj_reindex(context, column);
+    data.context = context;
+    data.column = column;
+    data.rc = GRN_SUCCESS;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_index_column_reindex_without_gvl,
+                                    &data);
     rb_grn_context_check(context, self);
-    rb_grn_rc_check(rc, self);
+    rb_grn_rc_check(data.rc, self);
 
     return Qnil;
 }
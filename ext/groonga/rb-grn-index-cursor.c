@@ -1,7 +1,7 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
   Copyright (C) 2011  Haruka Yoshihara <yoshihara@clear-code.com>
-  Copyright (C) 2012-2021  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2012-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2019  Horimoto Yasuhiro <horimoto@clear-code.com>
 
   This library is free software; you can redistribute it and/or
@@ -164,6 +164,155 @@ rb_grn_index_cursor_each (int argc, VALUE *argv, VALUE self)
     return Qnil;
 }
 
+#define N_POSTING_COLUMNS 6
+#define POSTING_CHUNK_SIZE 1024
+
+static const char *posting_column_names[N_POSTING_COLUMNS] = {
+    "term_id",
+    "record_id",
+    "section_id",
+    "position",
+    "term_frequency",
+    "weight",
+};
+
+static VALUE
+read_posting_columns (grn_ctx *context, grn_obj *cursor, long n_max_postings)
+{
+    VALUE rb_columns[N_POSTING_COLUMNS];
+    VALUE rb_result;
+    uint32_t chunk[N_POSTING_COLUMNS][POSTING_CHUNK_SIZE];
+    long n_postings = 0;
+    int n_chunk_postings = 0;
+    int i;
+    long capacity;
+
+    if (n_max_postings > 0 && n_max_postings < POSTING_CHUNK_SIZE) {
+        capacity = n_max_postings;
+    } else {
+        capacity = POSTING_CHUNK_SIZE;
+    }
+    for (i = 0; i < N_POSTING_COLUMNS; i++) {
+        rb_columns[i] = rb_str_buf_new(sizeof(uint32_t) * capacity);
+    }
+
+#define FLUSH_CHUNK() do {                                              \
+        for (i = 0; i < N_POSTING_COLUMNS; i++) {                       \
+            rb_str_cat(rb_columns[i],                                   \
+                       (const char *)chunk[i],                          \
+                       sizeof(uint32_t) * n_chunk_postings);            \
+        }                                                               \
+        n_chunk_postings = 0;                                           \
+    } while (0)
+
+    while (n_max_postings <= 0 || n_postings < n_max_postings) {
+        grn_posting *posting;
+        grn_id term_id;
+
+        posting = grn_index_cursor_next(context, cursor, &term_id);
+        if (!posting) {
+            break;
+        }
+        chunk[0][n_chunk_postings] = term_id;
+        chunk[1][n_chunk_postings] = posting->rid;
+        chunk[2][n_chunk_postings] = posting->sid;
+        chunk[3][n_chunk_postings] = posting->pos;
+        chunk[4][n_chunk_postings] = posting->tf;
+        chunk[5][n_chunk_postings] = posting->weight;
+        n_chunk_postings++;
+        n_postings++;
+        if (n_chunk_postings == POSTING_CHUNK_SIZE) {
+            FLUSH_CHUNK();
+        }
+    }
+    if (n_chunk_postings > 0) {
+        FLUSH_CHUNK();
+    }
+
+#undef FLUSH_CHUNK
+
+    if (n_postings == 0 && n_max_postings > 0) {
+        return Qnil;
+    }
+
+    rb_result = rb_hash_new();
+    for (i = 0; i < N_POSTING_COLUMNS; i++) {
+        rb_hash_aset(rb_result,
+                     ID2SYM(rb_intern(posting_column_names[i])),
+                     rb_columns[i]);
+    }
+    return rb_result;
+}
+
+/*
+ * Reads at most `n` postings at once. Posting values are returned
+ * as packed binary strings instead of {Groonga::Posting} objects.
+ * Each string has native endian unsigned 32bit integers. You can
+ * unpack it by `string.unpack("L*")` or wrap it by `IO::Buffer.for`.
+ *
+ * @example Sum term frequencies of all postings
+ *   total = 0
+ *   while (columns = cursor.read_batch(10000))
+ *     total += columns[:term_frequency].unpack("L*").sum
+ *   end
+ *
+ * @overload read_batch(n)
+ *   @param n [Integer] The max number of postings to be read.
+ *   @return [::Hash{Symbol => String}, nil] The packed values of the
+ *     read postings. Keys are `:term_id`, `:record_id`,
+ *     `:section_id`, `:position`, `:term_frequency` and `:weight`.
+ *     `nil` when there are no more postings.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_index_cursor_read_batch (VALUE self, VALUE rb_n)
+{
+    grn_obj *cursor;
+    grn_ctx *context;
+    long n;
+
+    n = NUM2LONG(rb_n);
+    if (n <= 0) {
+        rb_raise(rb_eArgError,
+                 "the number of postings must be positive: <%ld>", n);
+    }
+
+    rb_grn_index_cursor_deconstruct(SELF(self), &cursor, &context,
+                                    NULL, NULL, NULL, NULL);
+    if (!context || !cursor) {
+        return Qnil;
+    }
+
+    return read_posting_columns(context, cursor, n);
+}
+
+/*
+ * Reads all rest postings at once. See {#read_batch} for the
+ * format of the returned value.
+ *
+ * @overload to_columns
+ *   @return [::Hash{Symbol => String}] The packed values of all rest
+ *     postings. Each value is an empty string when there are no more
+ *     postings.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_index_cursor_to_columns (VALUE self)
+{
+    grn_obj *cursor;
+    grn_ctx *context;
+
+    rb_grn_index_cursor_deconstruct(SELF(self), &cursor, &context,
+                                    NULL, NULL, NULL, NULL);
+    if (!context || !cursor) {
+        return Qnil;
+    }
+
+    return read_posting_columns(context, cursor, 0);
+}
+
 void
 rb_grn_init_index_cursor (VALUE mGrn)
 {
@@ -179,4 +328,8 @@ rb_grn_init_index_cursor (VALUE mGrn)
 
     rb_define_method(rb_cGrnIndexCursor, "next", rb_grn_index_cursor_next, 0);
     rb_define_method(rb_cGrnIndexCursor, "each", rb_grn_index_cursor_each, -1);
+    rb_define_method(rb_cGrnIndexCursor, "read_batch",
+                     rb_grn_index_cursor_read_batch, 1);
+    rb_define_method(rb_cGrnIndexCursor, "to_columns",
+                     rb_grn_index_cursor_to_columns, 0);
 }
@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2015  Kouhei Sutou <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2016-2017  Masafumi Yokoyama <yokoyama@clear-code.com>
   Copyright (C) 2019  Horimoto Yasuhiro <horimoto@clear-code.com>
 
@@ -42,11 +42,38 @@ static ID id_label;
 static ID id_new;
 static ID id_parse;
 static ID id_log;
+static ID id_log_entries;
 static ID id_reopen;
 static ID id_fin;
+static ID id_start_flush_thread;
+static ID id_stop_flush_thread;
 
 static grn_logger rb_grn_logger;
 
+#ifdef HAVE_RUBY_THREAD_NATIVE_H
+#  define RB_GRN_LOGGER_BUFFER_AVAILABLE
+#endif
+
+typedef struct {
+    grn_log_level level;
+    size_t timestamp_size;
+    size_t title_size;
+    size_t message_size;
+    size_t location_size;
+    char data[];
+} BufferedLogEntry;
+
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+/* It's locked only while an entry pointer is pushed or entries are
+ * taken. No Ruby API is called while it's locked. */
+static rb_nativethread_lock_t rb_grn_logger_buffer_lock;
+#endif
+static BufferedLogEntry **rb_grn_logger_buffer = NULL;
+static size_t rb_grn_logger_buffer_capacity = 0;
+static size_t rb_grn_logger_buffer_head = 0;
+static size_t rb_grn_logger_buffer_n_entries = 0;
+static uint64_t rb_grn_logger_buffer_n_dropped_entries = 0;
+
 static grn_log_level
 rb_grn_log_level_from_ruby_object (VALUE rb_level)
 {
@@ -219,6 +246,8 @@ rb_grn_logger_s_log (int argc, VALUE *argv, VALUE klass)
     return Qnil;
 }
 
+static void rb_grn_logger_buffer_close (VALUE klass);
+
 static void
 rb_grn_logger_reset_with_error_check (VALUE klass, grn_ctx *context)
 {
@@ -227,6 +256,7 @@ rb_grn_logger_reset_with_error_check (VALUE klass, grn_ctx *context)
     current_logger = rb_cv_get(klass, "@@current_logger");
     if (NIL_P(current_logger))
         return;
+    rb_grn_logger_buffer_close(klass);
     rb_cv_set(klass, "@@current_logger", Qnil);
 
     if (context) {
@@ -243,23 +273,264 @@ rb_grn_logger_reset (VALUE klass)
     rb_grn_logger_reset_with_error_check(klass, NULL);
 }
 
+typedef struct {
+    VALUE handler;
+    grn_log_level level;
+    const char *timestamp;
+    const char *title;
+    const char *message;
+    const char *location;
+} LogData;
+
+static void *
+rb_grn_logger_log_with_gvl (void *user_data)
+{
+    LogData *data = user_data;
+
+    /* TODO: use rb_protect(). */
+    rb_funcall(data->handler, id_log, 5,
+               GRNLOGLEVEL2RVAL(data->level),
+               rb_str_new_cstr(data->timestamp),
+               rb_str_new_cstr(data->title),
+               rb_str_new_cstr(data->message),
+               rb_str_new_cstr(data->location));
+
+    return NULL;
+}
+
 static void
 rb_grn_logger_log (grn_ctx *ctx, grn_log_level level,
                    const char *timestamp, const char *title, const char *message,
                    const char *location, void *user_data)
 {
     VALUE handler = (VALUE)user_data;
+    LogData data;
 
     if (NIL_P(handler))
         return;
 
-    /* TODO: use rb_protect(). */
-    rb_funcall(handler, id_log, 5,
-               GRNLOGLEVEL2RVAL(level),
-               rb_str_new_cstr(timestamp),
-               rb_str_new_cstr(title),
-               rb_str_new_cstr(message),
-               rb_str_new_cstr(location));
+    data.handler = handler;
+    data.level = level;
+    data.timestamp = timestamp;
+    data.title = title;
+    data.message = message;
+    data.location = location;
+    /* This may be called while Groonga is running without the GVL. */
+    rb_grn_context_call_with_gvl(rb_grn_logger_log_with_gvl, &data);
+}
+
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+#  define STRING_SIZE(string) ((string) ? strlen(string) : 0)
+/*
+ * Copies a log entry to the buffer. It doesn't call any Ruby API. So
+ * it can be called from any thread without the GVL. The oldest entry
+ * is dropped when the buffer is full.
+ */
+static void
+rb_grn_logger_log_buffered (grn_ctx *ctx, grn_log_level level,
+                            const char *timestamp, const char *title,
+                            const char *message, const char *location,
+                            void *user_data)
+{
+    BufferedLogEntry *entry;
+    BufferedLogEntry *dropped_entry = NULL;
+    size_t timestamp_size = STRING_SIZE(timestamp);
+    size_t title_size = STRING_SIZE(title);
+    size_t message_size = STRING_SIZE(message);
+    size_t location_size = STRING_SIZE(location);
+    char *current;
+
+    entry = malloc(sizeof(BufferedLogEntry) +
+                   timestamp_size + title_size + message_size + location_size);
+    if (entry) {
+        entry->level = level;
+        entry->timestamp_size = timestamp_size;
+        entry->title_size = title_size;
+        entry->message_size = message_size;
+        entry->location_size = location_size;
+        current = entry->data;
+        memcpy(current, timestamp, timestamp_size);
+        current += timestamp_size;
+        memcpy(current, title, title_size);
+        current += title_size;
+        memcpy(current, message, message_size);
+        current += message_size;
+        memcpy(current, location, location_size);
+    }
+
+    rb_nativethread_lock_lock(&rb_grn_logger_buffer_lock);
+    if (!entry || !rb_grn_logger_buffer) {
+        dropped_entry = entry;
+        rb_grn_logger_buffer_n_dropped_entries++;
+    } else {
+        if (rb_grn_logger_buffer_n_entries == rb_grn_logger_buffer_capacity) {
+            dropped_entry = rb_grn_logger_buffer[rb_grn_logger_buffer_head];
+            rb_grn_logger_buffer_head =
+                (rb_grn_logger_buffer_head + 1) % rb_grn_logger_buffer_capacity;
+            rb_grn_logger_buffer_n_entries--;
+            rb_grn_logger_buffer_n_dropped_entries++;
+        }
+        rb_grn_logger_buffer[(rb_grn_logger_buffer_head +
+                              rb_grn_logger_buffer_n_entries) %
+                             rb_grn_logger_buffer_capacity] = entry;
+        rb_grn_logger_buffer_n_entries++;
+    }
+    rb_nativethread_lock_unlock(&rb_grn_logger_buffer_lock);
+
+    free(dropped_entry);
+}
+#  undef STRING_SIZE
+
+static VALUE
+rb_grn_logger_buffered_entry_to_ruby_object (BufferedLogEntry *entry)
+{
+    const char *current = entry->data;
+    VALUE rb_timestamp, rb_title, rb_message, rb_location;
+
+    rb_timestamp = rb_str_new(current, entry->timestamp_size);
+    current += entry->timestamp_size;
+    rb_title = rb_str_new(current, entry->title_size);
+    current += entry->title_size;
+    rb_message = rb_str_new(current, entry->message_size);
+    current += entry->message_size;
+    rb_location = rb_str_new(current, entry->location_size);
+
+    return rb_ary_new_from_args(5,
+                                GRNLOGLEVEL2RVAL(entry->level),
+                                rb_timestamp,
+                                rb_title,
+                                rb_message,
+                                rb_location);
+}
+#endif
+
+/*
+ * Delivers log entries in the buffer to the registered logger by
+ * {Groonga::Logger#log_entries}. It's called periodically by a
+ * background thread when the logger is registered with `:buffered`.
+ *
+ * It does nothing when the registered logger isn't buffered.
+ *
+ * @overload flush
+ *   @return [void]
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_logger_s_flush (VALUE klass)
+{
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+    BufferedLogEntry **entries;
+    size_t i, n_entries;
+    VALUE rb_entries;
+    VALUE current_logger;
+
+    if (!rb_grn_logger_buffer) {
+        return Qnil;
+    }
+
+    rb_nativethread_lock_lock(&rb_grn_logger_buffer_lock);
+    n_entries = rb_grn_logger_buffer_n_entries;
+    entries = malloc(sizeof(BufferedLogEntry *) * (n_entries + 1));
+    if (entries) {
+        for (i = 0; i < n_entries; i++) {
+            entries[i] =
+                rb_grn_logger_buffer[(rb_grn_logger_buffer_head + i) %
+                                     rb_grn_logger_buffer_capacity];
+        }
+        rb_grn_logger_buffer_head = 0;
+        rb_grn_logger_buffer_n_entries = 0;
+    }
+    rb_nativethread_lock_unlock(&rb_grn_logger_buffer_lock);
+    if (!entries) {
+        rb_raise(rb_eNoMemError, "failed to allocate buffered log entries");
+    }
+    if (n_entries == 0) {
+        free(entries);
+        return Qnil;
+    }
+
+    rb_entries = rb_ary_new_capa(n_entries);
+    for (i = 0; i < n_entries; i++) {
+        rb_ary_push(rb_entries,
+                    rb_grn_logger_buffered_entry_to_ruby_object(entries[i]));
+        free(entries[i]);
+    }
+    free(entries);
+
+    current_logger = rb_cv_get(klass, "@@current_logger");
+    if (!NIL_P(current_logger)) {
+        rb_funcall(current_logger, id_log_entries, 1, rb_entries);
+    }
+#endif
+
+    return Qnil;
+}
+
+/*
+ * @overload n_dropped_entries
+ *   @return [Integer] The number of log entries that are dropped
+ *     because the buffer of the buffered logger is full.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_logger_s_get_n_dropped_entries (VALUE klass)
+{
+    return ULL2NUM(rb_grn_logger_buffer_n_dropped_entries);
+}
+
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+static void
+rb_grn_logger_buffer_open (size_t capacity)
+{
+    BufferedLogEntry **buffer;
+
+    buffer = ALLOC_N(BufferedLogEntry *, capacity);
+    rb_nativethread_lock_lock(&rb_grn_logger_buffer_lock);
+    rb_grn_logger_buffer = buffer;
+    rb_grn_logger_buffer_capacity = capacity;
+    rb_grn_logger_buffer_head = 0;
+    rb_grn_logger_buffer_n_entries = 0;
+    rb_nativethread_lock_unlock(&rb_grn_logger_buffer_lock);
+}
+#endif
+
+/*
+ * Stops the flush thread, delivers the rest entries to the current
+ * logger and frees the buffer.
+ */
+static void
+rb_grn_logger_buffer_close (VALUE klass)
+{
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+    BufferedLogEntry **buffer;
+    size_t i, head, n_entries, capacity;
+
+    if (!rb_grn_logger_buffer) {
+        return;
+    }
+
+    rb_funcall(klass, id_stop_flush_thread, 0);
+    rb_grn_logger_s_flush(klass);
+
+    rb_nativethread_lock_lock(&rb_grn_logger_buffer_lock);
+    buffer = rb_grn_logger_buffer;
+    head = rb_grn_logger_buffer_head;
+    n_entries = rb_grn_logger_buffer_n_entries;
+    capacity = rb_grn_logger_buffer_capacity;
+    rb_grn_logger_buffer = NULL;
+    rb_grn_logger_buffer_capacity = 0;
+    rb_grn_logger_buffer_head = 0;
+    rb_grn_logger_buffer_n_entries = 0;
+    rb_nativethread_lock_unlock(&rb_grn_logger_buffer_lock);
+
+    /* Entries may be added between flush and close. */
+    for (i = 0; i < n_entries; i++) {
+        free(buffer[(head + i) % capacity]);
+    }
+    xfree(buffer);
+#endif
 }
 
 static void
@@ -282,6 +553,10 @@ rb_grn_logger_fin (grn_ctx *ctx, void *user_data)
     if (NIL_P(handler))
         return;
 
+    /* grn_fin() may finalize the logger without unregistering it. We
+     * need to deliver the rest buffered entries before finalizing. */
+    rb_grn_logger_s_flush(rb_cGrnLogger);
+
     /* TODO: use rb_protect(). */
     rb_funcall(handler, id_fin, 0);
 }
@@ -318,6 +593,25 @@ rb_grn_logger_fin (grn_ctx *ctx, void *user_data)
  *     定する。デフォルトでは渡す。
  *   @option options [Bool] :thread_id (true)
  *     Specifies whether `location` includes thread ID or not.
+ *   @option options [Bool] :buffered (false)
+ *     If it's `true`, log entries are copied to a buffer in C
+ *     without calling Ruby and they are delivered to
+ *     {Groonga::Logger#log_entries} by a background thread. Groonga
+ *     can log without the GVL. Log entries are delivered
+ *     asynchronously. Use {Groonga::Logger.flush} to deliver them
+ *     immediately.
+ *
+ *     It's available since 15.0.5.
+ *   @option options [Integer] :buffer_size (4096)
+ *     The max number of buffered log entries. The oldest entry is
+ *     dropped when the buffer is full. See
+ *     {Groonga::Logger.n_dropped_entries}.
+ *
+ *     It's available since 15.0.5.
+ *   @option options [Numeric] :flush_interval (0.1)
+ *     The interval in seconds to deliver buffered log entries.
+ *
+ *     It's available since 15.0.5.
  */
 static VALUE
 rb_grn_logger_s_register (int argc, VALUE *argv, VALUE klass)
@@ -334,8 +628,13 @@ rb_grn_logger_s_register (int argc, VALUE *argv, VALUE klass)
     VALUE rb_location;
     VALUE rb_thread_id;
     VALUE rb_flags;
+    VALUE rb_buffered;
+    VALUE rb_buffer_size;
+    VALUE rb_flush_interval;
     grn_log_level max_level = GRN_LOG_DEFAULT_LEVEL;
     int flags = 0;
+    grn_bool buffered;
+    long buffer_size = 4096;
 
     rb_scan_args(argc, argv, "02&", &rb_logger, &rb_options, &rb_callback);
 
@@ -354,7 +653,28 @@ rb_grn_logger_s_register (int argc, VALUE *argv, VALUE klass)
                         "location",  &rb_location,
                         "thread_id", &rb_thread_id,
                         "flags",     &rb_flags,
+                        "buffered",  &rb_buffered,
+                        "buffer_size", &rb_buffer_size,
+                        "flush_interval", &rb_flush_interval,
                         NULL);
+    buffered = RVAL2CBOOL(rb_buffered);
+#ifndef RB_GRN_LOGGER_BUFFER_AVAILABLE
+    if (buffered) {
+        rb_raise(rb_eNotImpError,
+                 "buffered logger requires ruby/thread_native.h");
+    }
+#endif
+    if (!NIL_P(rb_buffer_size)) {
+        buffer_size = NUM2LONG(rb_buffer_size);
+        if (buffer_size < 1) {
+            rb_raise(rb_eArgError,
+                     "buffer size must be positive: %" PRIsVALUE,
+                     rb_buffer_size);
+        }
+    }
+    if (NIL_P(rb_flush_interval)) {
+        rb_flush_interval = rb_float_new(0.1);
+    }
     if (!NIL_P(rb_max_level)) {
         max_level = RVAL2GRNLOGLEVEL(rb_max_level);
     }
@@ -379,14 +699,26 @@ rb_grn_logger_s_register (int argc, VALUE *argv, VALUE klass)
                            INT2NUM(flags), rb_flags);
     }
 
+    rb_grn_logger_buffer_close(klass);
     rb_grn_logger.max_level = max_level;
     rb_grn_logger.flags = flags;
     rb_grn_logger.user_data = (void *)rb_logger;
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+    if (buffered) {
+        rb_grn_logger_buffer_open(buffer_size);
+        rb_grn_logger.log = rb_grn_logger_log_buffered;
+    } else {
+        rb_grn_logger.log = rb_grn_logger_log;
+    }
+#endif
 
     context = rb_grn_context_ensure(&rb_context);
     grn_logger_set(context, &rb_grn_logger);
     rb_grn_context_check(context, rb_logger);
     rb_cv_set(klass, "@@current_logger", rb_logger);
+    if (buffered) {
+        rb_funcall(klass, id_start_flush_thread, 1, rb_flush_interval);
+    }
 
     return Qnil;
 }
@@ -409,6 +741,7 @@ rb_grn_logger_s_unregister (VALUE klass)
     if (NIL_P(current_logger))
         return Qnil;
 
+    rb_grn_logger_buffer_close(klass);
     rb_cv_set(klass, "@@current_logger", Qnil);
 
     context = rb_grn_context_ensure(&rb_context);
@@ -659,8 +992,15 @@ rb_grn_init_logger (VALUE mGrn)
     id_new    = rb_intern("new");
     id_parse  = rb_intern("parse");
     id_log    = rb_intern("log");
+    id_log_entries = rb_intern("log_entries");
     id_reopen = rb_intern("reopen");
     id_fin    = rb_intern("fin");
+    id_start_flush_thread = rb_intern("start_flush_thread");
+    id_stop_flush_thread  = rb_intern("stop_flush_thread");
+
+#ifdef RB_GRN_LOGGER_BUFFER_AVAILABLE
+    rb_nativethread_lock_initialize(&rb_grn_logger_buffer_lock);
+#endif
 
     rb_grn_logger.log    = rb_grn_logger_log;
     rb_grn_logger.reopen = rb_grn_logger_reopen;
@@ -679,6 +1019,10 @@ rb_grn_init_logger (VALUE mGrn)
                                rb_grn_logger_s_unregister, 0);
     rb_define_singleton_method(rb_cGrnLogger, "reopen",
                                rb_grn_logger_s_reopen, 0);
+    rb_define_singleton_method(rb_cGrnLogger, "flush",
+                               rb_grn_logger_s_flush, 0);
+    rb_define_singleton_method(rb_cGrnLogger, "n_dropped_entries",
+                               rb_grn_logger_s_get_n_dropped_entries, 0);
     rb_define_singleton_method(rb_cGrnLogger, "max_level",
                                rb_grn_logger_s_get_max_level, 0);
     rb_define_singleton_method(rb_cGrnLogger, "max_level=",
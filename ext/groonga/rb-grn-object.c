@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2022  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2014-2016  Masafumi Yokoyama <yokoyama@clear-code.com>
   Copyright (C) 2019  Horimoto Yasuhiro <horimoto@clear-code.com>
 
@@ -110,6 +110,18 @@ rb_grn_object_from_ruby_object (VALUE object, grn_ctx **context)
     return rb_grn_object->object;
 }
 
+/*
+ * Returns whether the object is bound to a context detached by
+ * Groonga::Context#reopen_after_fork. The grn_ctx of the object is
+ * inherited from the parent process and must not be touched.
+ */
+static grn_bool
+rb_grn_object_is_detached (RbGrnObject *rb_grn_object)
+{
+    return rb_grn_object->rb_grn_context &&
+        rb_grn_object->rb_grn_context->detached;
+}
+
 static void
 rb_grn_object_unbind (RbGrnObject *rb_grn_object)
 {
@@ -132,6 +144,9 @@ rb_grn_object_run_finalizer (grn_ctx *context, grn_obj *grn_object,
     if (rb_grn_exited)
         return;
 
+    if (rb_grn_object_is_detached(rb_grn_object))
+        return;
+
     grn_obj_set_finalizer(context, grn_object, NULL);
 
     debug("finalize: %p:%p:%p:%p:%p:%p %s(%#x)\n",
@@ -214,6 +229,8 @@ rb_grn_object_finalizer (grn_ctx *context, int n_args, grn_obj **grn_objects,
         return NULL;
 
     rb_grn_object = user_data->ptr;
+    if (rb_grn_object_is_detached(rb_grn_object))
+        return NULL;
 
     grn_obj_user_data(context, grn_object)->ptr = NULL;
     rb_grn_object_run_finalizer(context, grn_object, rb_grn_object);
@@ -231,7 +248,9 @@ rb_grn_object_free (RbGrnObject *rb_grn_object)
     grn_object = rb_grn_object->object;
     debug("rb-free: %p:%p:%p; %d:%d\n", context, grn_object, rb_grn_object,
           rb_grn_object->have_finalizer, rb_grn_object->need_close);
-    if (!rb_grn_exited && context && grn_object &&
+    if (!rb_grn_exited &&
+        !rb_grn_object_is_detached(rb_grn_object) &&
+        context && grn_object &&
         (rb_grn_object->have_finalizer || rb_grn_object->need_close)) {
         grn_user_data *user_data = NULL;
 
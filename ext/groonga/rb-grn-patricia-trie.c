@@ -1,7 +1,7 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /* vim: set sts=4 sw=4 ts=8 noet: */
 /*
-  Copyright (C) 2009-2022  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 
   This library is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
@@ -502,6 +502,244 @@ rb_grn_patricia_trie_scan (VALUE self, VALUE rb_string)
     return rb_result;
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    const char *string;
+    long string_length;
+    uint32_t *hits;
+    size_t n_hits;
+    size_t hits_capacity;
+    grn_bool no_memory;
+} ScanPackedData;
+
+#define SCAN_PACKED_HIT_SIZE 3
+
+static grn_bool
+scan_packed_add_hit (ScanPackedData *data,
+                     grn_id id, uint32_t offset, uint32_t length)
+{
+    uint32_t *hit;
+
+    if (data->n_hits == data->hits_capacity) {
+        size_t new_capacity;
+        uint32_t *new_hits;
+
+        new_capacity = data->hits_capacity * 2;
+        if (new_capacity == 0) {
+            new_capacity = 1024;
+        }
+        /* We can't use xrealloc() here because the GVL may be
+         * released. */
+        new_hits = realloc(data->hits,
+                           sizeof(uint32_t) *
+                           SCAN_PACKED_HIT_SIZE *
+                           new_capacity);
+        if (!new_hits) {
+            data->no_memory = GRN_TRUE;
+            return GRN_FALSE;
+        }
+        data->hits = new_hits;
+        data->hits_capacity = new_capacity;
+    }
+
+    hit = data->hits + (data->n_hits * SCAN_PACKED_HIT_SIZE);
+    hit[0] = id;
+    hit[1] = offset;
+    hit[2] = length;
+    data->n_hits++;
+    return GRN_TRUE;
+}
+
+static void *
+rb_grn_patricia_trie_scan_packed_without_gvl (void *user_data)
+{
+    ScanPackedData *data = user_data;
+    grn_pat_scan_hit hits[1024];
+    const char *string = data->string;
+    long string_length = data->string_length;
+
+    while (string_length > 0) {
+        const char *rest;
+        int i, n_hits;
+        unsigned int previous_offset = 0;
+        uint32_t rest_offset = string - data->string;
+
+        n_hits = grn_pat_scan(data->context, (grn_pat *)(data->table),
+                              string, string_length,
+                              hits, sizeof(hits) / sizeof(*hits),
+                              &rest);
+        for (i = 0; i < n_hits; i++) {
+            if (hits[i].offset < previous_offset)
+                continue;
+            if (!scan_packed_add_hit(data,
+                                     hits[i].id,
+                                     hits[i].offset + rest_offset,
+                                     hits[i].length)) {
+                return NULL;
+            }
+            previous_offset = hits[i].offset;
+        }
+        if (rest == string) {
+            break;
+        }
+        string_length -= rest - string;
+        string = rest;
+    }
+
+    return NULL;
+}
+
+static void
+rb_grn_patricia_trie_scan_packed_raw (VALUE self,
+                                      VALUE rb_string,
+                                      ScanPackedData *data)
+{
+    grn_ctx *context;
+    grn_obj *table;
+
+    StringValue(rb_string);
+    rb_grn_table_key_support_deconstruct(SELF(self), &table, &context,
+                                         NULL, NULL, NULL,
+                                         NULL, NULL, NULL,
+                                         NULL);
+
+    data->context = context;
+    data->table = table;
+    data->string = RSTRING_PTR(rb_string);
+    data->string_length = RSTRING_LEN(rb_string);
+    data->hits = NULL;
+    data->n_hits = 0;
+    data->hits_capacity = 0;
+    data->no_memory = GRN_FALSE;
+
+    /* rb_string must not be changed by other threads while the GVL
+     * is released. */
+    rb_str_locktmp(rb_string);
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_patricia_trie_scan_packed_without_gvl,
+                                    data);
+    rb_str_unlocktmp(rb_string);
+
+    if (data->no_memory) {
+        free(data->hits);
+        rb_raise(rb_eNoMemError,
+                 "failed to allocate memory for scan hits: <%" PRIsVALUE ">",
+                 self);
+    }
+}
+
+/*
+ * Scans `string` like {#scan} but returns hits as packed binary
+ * strings. {Groonga::Record} and matched word aren't created for
+ * each hit. Each packed string has native endian unsigned 32bit
+ * integers. You can unpack it by `string.unpack("L*")` or wrap it
+ * by `IO::Buffer.for`.
+ *
+ * The GVL is released while `string` is scanned when the context is
+ * created with `release_gvl: true`.
+ *
+ * @example
+ *   ids, offsets, lengths = words.scan_packed(text)
+ *   ids.unpack("L*").zip(offsets.unpack("L*"), lengths.unpack("L*"))
+ *
+ * @overload scan_packed(string)
+ *   @param string [String] The string to be scanned.
+ *   @return [::Array<String>] `[ids, offsets, lengths]`. `ids` is
+ *     record IDs of matched keys. `offsets` and `lengths` are byte
+ *     offsets and byte lengths of matched words in `string`.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_patricia_trie_scan_packed (VALUE self, VALUE rb_string)
+{
+    ScanPackedData data;
+    VALUE rb_columns[SCAN_PACKED_HIT_SIZE];
+    size_t i;
+    int j;
+
+    rb_grn_patricia_trie_scan_packed_raw(self, rb_string, &data);
+
+    for (j = 0; j < SCAN_PACKED_HIT_SIZE; j++) {
+        rb_columns[j] = rb_str_new(NULL, sizeof(uint32_t) * data.n_hits);
+    }
+    for (i = 0; i < data.n_hits; i++) {
+        uint32_t *hit = data.hits + (i * SCAN_PACKED_HIT_SIZE);
+        for (j = 0; j < SCAN_PACKED_HIT_SIZE; j++) {
+            memcpy(RSTRING_PTR(rb_columns[j]) + sizeof(uint32_t) * i,
+                   hit + j,
+                   sizeof(uint32_t));
+        }
+    }
+    free(data.hits);
+
+    return rb_ary_new_from_values(SCAN_PACKED_HIT_SIZE, rb_columns);
+}
+
+/*
+ * @api private
+ *
+ * `rb_open_tag_parts` is the open tag split by `%{id}`. The record
+ * ID of the matched key is inserted between each part.
+ */
+static VALUE
+rb_grn_patricia_trie_tag_keys_native (VALUE self,
+                                      VALUE rb_text,
+                                      VALUE rb_open_tag_parts,
+                                      VALUE rb_close_tag)
+{
+    ScanPackedData data;
+    VALUE rb_result;
+    const char *text;
+    long text_length;
+    long position = 0;
+    long j, n_open_tag_parts;
+    size_t i;
+
+    rb_open_tag_parts = rb_ary_dup(rb_grn_convert_to_array(rb_open_tag_parts));
+    n_open_tag_parts = RARRAY_LEN(rb_open_tag_parts);
+    for (j = 0; j < n_open_tag_parts; j++) {
+        VALUE rb_open_tag_part = RARRAY_AREF(rb_open_tag_parts, j);
+        StringValue(rb_open_tag_part);
+        rb_ary_store(rb_open_tag_parts, j, rb_open_tag_part);
+    }
+    StringValue(rb_close_tag);
+
+    rb_grn_patricia_trie_scan_packed_raw(self, rb_text, &data);
+
+    text = RSTRING_PTR(rb_text);
+    text_length = RSTRING_LEN(rb_text);
+    rb_result = rb_str_buf_new(text_length);
+    rb_enc_associate(rb_result, rb_enc_get(rb_text));
+    for (i = 0; i < data.n_hits; i++) {
+        uint32_t *hit = data.hits + (i * SCAN_PACKED_HIT_SIZE);
+        grn_id id = hit[0];
+        uint32_t offset = hit[1];
+        uint32_t length = hit[2];
+        char id_buffer[16];
+        int id_length = 0;
+
+        if (n_open_tag_parts > 1) {
+            id_length = snprintf(id_buffer, sizeof(id_buffer), "%u", id);
+        }
+        rb_str_cat(rb_result, text + position, offset - position);
+        for (j = 0; j < n_open_tag_parts; j++) {
+            if (j > 0) {
+                rb_str_cat(rb_result, id_buffer, id_length);
+            }
+            rb_str_buf_append(rb_result, RARRAY_AREF(rb_open_tag_parts, j));
+        }
+        rb_str_cat(rb_result, text + offset, length);
+        rb_str_buf_append(rb_result, rb_close_tag);
+        position = offset + length;
+    }
+    free(data.hits);
+    rb_str_cat(rb_result, text + position, text_length - position);
+
+    return rb_result;
+}
+
 /*
  * キーが _prefix_ に前方一致するレコードのIDがキーに入っている
  * {Groonga::Hash} を返す。マッチするレコードがない場合は空の
@@ -930,6 +1168,10 @@ rb_grn_init_patricia_trie (VALUE mGrn)
                      rb_grn_patricia_trie_search, -1);
     rb_define_method(rb_cGrnPatriciaTrie, "scan",
                      rb_grn_patricia_trie_scan, 1);
+    rb_define_method(rb_cGrnPatriciaTrie, "scan_packed",
+                     rb_grn_patricia_trie_scan_packed, 1);
+    rb_define_private_method(rb_cGrnPatriciaTrie, "tag_keys_native",
+                             rb_grn_patricia_trie_tag_keys_native, 3);
     rb_define_method(rb_cGrnPatriciaTrie, "prefix_search",
                      rb_grn_patricia_trie_prefix_search, 1);
 
@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2012-2018  Kouhei Sutou <kou@clear-code.com>
+  Copyright (C) 2012-2025  Sutou Kouhei <kou@clear-code.com>
 
   This library is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
@@ -38,6 +38,10 @@ static ID id_reopen;
 static ID id_fin;
 
 static grn_query_logger rb_grn_query_logger;
+/* The flags requested to Groonga only for statistics. Entries only
+ * for them aren't passed to the registered logger. */
+static unsigned int rb_grn_query_logger_statistics_only_flags =
+    GRN_QUERY_LOG_NONE;
 
 static VALUE
 rb_grn_query_log_flags_to_ruby_object (unsigned int flags)
@@ -99,8 +103,8 @@ rb_grn_query_logger_s_log (int argc, VALUE *argv, VALUE klass)
     context = rb_grn_context_ensure(&rb_context);
 
     if (!NIL_P(rb_flags)) {
-        flags = rb_funcall(mGrnQueryLoggerFlags, id_parse, 2,
-                           rb_flags, UINT2NUM(flags));
+        flags = NUM2UINT(rb_funcall(mGrnQueryLoggerFlags, id_parse, 2,
+                                    rb_flags, UINT2NUM(flags)));
     }
     if (!NIL_P(rb_mark)) {
         mark = StringValueCStr(rb_mark);
@@ -111,22 +115,482 @@ rb_grn_query_logger_s_log (int argc, VALUE *argv, VALUE klass)
     return Qnil;
 }
 
+#ifdef HAVE_RUBY_THREAD_NATIVE_H
+#  define RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+#endif
+
+/*
+ * Latency histogram with log-linear buckets like HDR histogram. Each
+ * power of two range is split into 16 linear sub buckets. So the
+ * relative error of a recorded value is less than 1/16.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_N_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_N_BUCKETS (64 * HISTOGRAM_N_SUB_BUCKETS)
+#define STATISTICS_MAX_NAME_SIZE 64
+#define STATISTICS_MAX_N_RUNNING_COMMANDS 1024
+
+typedef struct {
+    char command[STATISTICS_MAX_NAME_SIZE];
+    char stage[STATISTICS_MAX_NAME_SIZE];
+    uint64_t n_samples;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+    uint64_t buckets[HISTOGRAM_N_BUCKETS];
+} QueryStatistics;
+
+typedef struct {
+    grn_ctx *context;
+    char command[STATISTICS_MAX_NAME_SIZE];
+    uint64_t previous_elapsed_time;
+} RunningCommand;
+
+static grn_bool rb_grn_query_statistics_enabled = GRN_FALSE;
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+/* It guards all statistics variables. Query log callbacks may be
+ * called by threads without the GVL. */
+static rb_nativethread_lock_t rb_grn_query_statistics_lock;
+static double rb_grn_query_statistics_sampling_rate = 1.0;
+static uint64_t rb_grn_query_statistics_random_state = 88172645463325252ULL;
+static QueryStatistics **rb_grn_query_statistics = NULL;
+static size_t rb_grn_query_statistics_size = 0;
+static size_t rb_grn_query_statistics_capacity = 0;
+static RunningCommand rb_grn_query_running_commands[STATISTICS_MAX_N_RUNNING_COMMANDS];
+static size_t rb_grn_query_n_running_commands = 0;
+
+static int
+rb_grn_query_histogram_bucket_index (uint64_t value)
+{
+    int msb = 0;
+    int shift;
+    uint64_t rest;
+
+    if (value < HISTOGRAM_N_SUB_BUCKETS) {
+        return (int)value;
+    }
+    for (rest = value; rest > 1; rest >>= 1) {
+        msb++;
+    }
+    shift = msb - HISTOGRAM_SUB_BUCKET_BITS;
+    return (shift + 1) * HISTOGRAM_N_SUB_BUCKETS +
+        (int)((value >> shift) & (HISTOGRAM_N_SUB_BUCKETS - 1));
+}
+
+/* Returns the middle value of the bucket. */
+static uint64_t
+rb_grn_query_histogram_bucket_value (int index)
+{
+    int shift;
+    uint64_t lower;
+
+    if (index < HISTOGRAM_N_SUB_BUCKETS) {
+        return index;
+    }
+    shift = index / HISTOGRAM_N_SUB_BUCKETS - 1;
+    lower = ((uint64_t)(HISTOGRAM_N_SUB_BUCKETS +
+                        index % HISTOGRAM_N_SUB_BUCKETS)) << shift;
+    return lower + ((((uint64_t)1) << shift) >> 1);
+}
+
+static void
+rb_grn_query_statistics_copy_name (char *destination,
+                                   const char *source,
+                                   size_t source_size)
+{
+    if (source_size >= STATISTICS_MAX_NAME_SIZE) {
+        source_size = STATISTICS_MAX_NAME_SIZE - 1;
+    }
+    memcpy(destination, source, source_size);
+    destination[source_size] = '\0';
+}
+
+/* It must be called with the lock. */
+static void
+rb_grn_query_statistics_record (const char *command,
+                                const char *stage,
+                                uint64_t value)
+{
+    QueryStatistics *statistics = NULL;
+    size_t i;
+
+    for (i = 0; i < rb_grn_query_statistics_size; i++) {
+        if (strcmp(rb_grn_query_statistics[i]->command, command) == 0 &&
+            strcmp(rb_grn_query_statistics[i]->stage, stage) == 0) {
+            statistics = rb_grn_query_statistics[i];
+            break;
+        }
+    }
+    if (!statistics) {
+        if (rb_grn_query_statistics_size == rb_grn_query_statistics_capacity) {
+            size_t new_capacity;
+            QueryStatistics **new_statistics;
+
+            new_capacity = rb_grn_query_statistics_capacity * 2;
+            if (new_capacity == 0) {
+                new_capacity = 16;
+            }
+            new_statistics = realloc(rb_grn_query_statistics,
+                                     sizeof(QueryStatistics *) * new_capacity);
+            if (!new_statistics) {
+                return;
+            }
+            rb_grn_query_statistics = new_statistics;
+            rb_grn_query_statistics_capacity = new_capacity;
+        }
+        statistics = calloc(1, sizeof(QueryStatistics));
+        if (!statistics) {
+            return;
+        }
+        rb_grn_query_statistics_copy_name(statistics->command,
+                                          command, strlen(command));
+        rb_grn_query_statistics_copy_name(statistics->stage,
+                                          stage, strlen(stage));
+        rb_grn_query_statistics[rb_grn_query_statistics_size++] = statistics;
+    }
+
+    if (statistics->n_samples == 0 || value < statistics->min) {
+        statistics->min = value;
+    }
+    if (value > statistics->max) {
+        statistics->max = value;
+    }
+    statistics->n_samples++;
+    statistics->sum += value;
+    statistics->buckets[rb_grn_query_histogram_bucket_index(value)]++;
+}
+
+/* xorshift64. It must be called with the lock. */
+static double
+rb_grn_query_statistics_random (void)
+{
+    uint64_t x = rb_grn_query_statistics_random_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    rb_grn_query_statistics_random_state = x;
+    return (double)(x >> 11) / (double)(((uint64_t)1) << 53);
+}
+
+static RunningCommand *
+rb_grn_query_statistics_find_running_command (grn_ctx *ctx)
+{
+    size_t i;
+
+    for (i = 0; i < rb_grn_query_n_running_commands; i++) {
+        if (rb_grn_query_running_commands[i].context == ctx) {
+            return &(rb_grn_query_running_commands[i]);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Parses a query log entry and updates statistics. It doesn't call
+ * any Ruby API. Entries are the followings:
+ *
+ *   info: "${context_id}|>", message: "select ..." (command)
+ *   info: "${context_id}|:${elapsed_time} ", message: "filter(10)" (stage)
+ *   info: "${context_id}|<${elapsed_time} ", message: "rc=0" (end)
+ *
+ * Elapsed time is nanoseconds from the start of the command.
+ */
+static void
+rb_grn_query_statistics_update (grn_ctx *ctx,
+                                const char *info,
+                                const char *message)
+{
+    const char *mark;
+    RunningCommand *running_command;
+
+    if (!info || !message) {
+        return;
+    }
+    mark = strchr(info, '|');
+    if (!mark) {
+        return;
+    }
+    mark++;
+
+    rb_nativethread_lock_lock(&rb_grn_query_statistics_lock);
+    running_command = rb_grn_query_statistics_find_running_command(ctx);
+    switch (mark[0]) {
+    case '>':
+        if (running_command) {
+            /* The previous command isn't finished normally. */
+            *running_command =
+                rb_grn_query_running_commands[--rb_grn_query_n_running_commands];
+            running_command = NULL;
+        }
+        if (rb_grn_query_n_running_commands ==
+            STATISTICS_MAX_N_RUNNING_COMMANDS) {
+            break;
+        }
+        if (rb_grn_query_statistics_sampling_rate < 1.0 &&
+            rb_grn_query_statistics_random() >=
+            rb_grn_query_statistics_sampling_rate) {
+            break;
+        }
+        {
+            const char *name = message;
+            size_t name_size = 0;
+
+            if (name[0] == '/') {
+                name++;
+                if (strncmp(name, "d/", 2) == 0) {
+                    name += 2;
+                }
+            }
+            while (name[name_size] != '\0' &&
+                   name[name_size] != ' ' &&
+                   name[name_size] != '?' &&
+                   name[name_size] != '.') {
+                name_size++;
+            }
+            running_command =
+                &(rb_grn_query_running_commands[rb_grn_query_n_running_commands++]);
+            running_command->context = ctx;
+            rb_grn_query_statistics_copy_name(running_command->command,
+                                              name, name_size);
+            running_command->previous_elapsed_time = 0;
+        }
+        break;
+    case ':':
+        if (running_command) {
+            char stage[STATISTICS_MAX_NAME_SIZE];
+            size_t stage_size = 0;
+            uint64_t elapsed_time;
+
+            elapsed_time = strtoull(mark + 1, NULL, 10);
+            while (message[stage_size] == '_' ||
+                   ('a' <= message[stage_size] && message[stage_size] <= 'z') ||
+                   ('A' <= message[stage_size] && message[stage_size] <= 'Z')) {
+                stage_size++;
+            }
+            rb_grn_query_statistics_copy_name(stage, message, stage_size);
+            if (elapsed_time >= running_command->previous_elapsed_time) {
+                rb_grn_query_statistics_record(
+                    running_command->command,
+                    stage,
+                    elapsed_time - running_command->previous_elapsed_time);
+            }
+            running_command->previous_elapsed_time = elapsed_time;
+        }
+        break;
+    case '<':
+        if (running_command) {
+            rb_grn_query_statistics_record(running_command->command,
+                                           "total",
+                                           strtoull(mark + 1, NULL, 10));
+            *running_command =
+                rb_grn_query_running_commands[--rb_grn_query_n_running_commands];
+        }
+        break;
+    default:
+        break;
+    }
+    rb_nativethread_lock_unlock(&rb_grn_query_statistics_lock);
+}
+
+static VALUE
+rb_grn_query_statistics_to_ruby_object (QueryStatistics *statistics)
+{
+    VALUE rb_statistics;
+    double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+    const char *percentile_names[] = {"p50", "p90", "p99", "p999"};
+    size_t i;
+
+    rb_statistics = rb_hash_new();
+    rb_hash_aset(rb_statistics, RB_GRN_INTERN("n_samples"),
+                 ULL2NUM(statistics->n_samples));
+    rb_hash_aset(rb_statistics, RB_GRN_INTERN("min"),
+                 rb_float_new(statistics->min / 1000000000.0));
+    rb_hash_aset(rb_statistics, RB_GRN_INTERN("max"),
+                 rb_float_new(statistics->max / 1000000000.0));
+    rb_hash_aset(rb_statistics, RB_GRN_INTERN("mean"),
+                 rb_float_new(statistics->sum / 1000000000.0 /
+                              statistics->n_samples));
+    for (i = 0; i < sizeof(percentiles) / sizeof(*percentiles); i++) {
+        uint64_t rank;
+        uint64_t n_samples = 0;
+        uint64_t value = statistics->max;
+        int j;
+
+        rank = (uint64_t)(statistics->n_samples * percentiles[i] / 100.0);
+        if (rank == 0) {
+            rank = 1;
+        }
+        for (j = 0; j < HISTOGRAM_N_BUCKETS; j++) {
+            n_samples += statistics->buckets[j];
+            if (n_samples >= rank) {
+                value = rb_grn_query_histogram_bucket_value(j);
+                break;
+            }
+        }
+        if (value < statistics->min) {
+            value = statistics->min;
+        }
+        if (value > statistics->max) {
+            value = statistics->max;
+        }
+        rb_hash_aset(rb_statistics, RB_GRN_INTERN(percentile_names[i]),
+                     rb_float_new(value / 1000000000.0));
+    }
+
+    return rb_statistics;
+}
+#endif
+
+/*
+ * Returns a snapshot of query statistics collected by the query
+ * logger registered with `:statistics => true`.
+ *
+ * Statistics are grouped by command name and stage name. Stage names
+ * are the names in query log such as `"filter"`, `"sort"`,
+ * `"output"` and `"drilldown"`. The elapsed time of each stage is the
+ * time from the previous stage. `"total"` is the elapsed time of the
+ * whole command.
+ *
+ * @example Show p99 of select
+ *   Groonga::QueryLogger.register(nil, :statistics => true)
+ *   # ...
+ *   p Groonga::QueryLogger.statistics["select"]["total"][:p99]
+ *
+ * @overload statistics
+ *   @return [::Hash{String => ::Hash{String => ::Hash{Symbol => Numeric}}}]
+ *     The statistics for each command and stage. Each statistics has
+ *     `:n_samples`, `:min`, `:max`, `:mean`, `:p50`, `:p90`, `:p99`
+ *     and `:p999`. Elapsed times are in seconds. Percentiles are
+ *     computed from a log-linear histogram. So they have up to 1/16
+ *     relative error.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_query_logger_s_get_statistics (VALUE klass)
+{
+    VALUE rb_statistics = rb_hash_new();
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    QueryStatistics *snapshot;
+    size_t i, n_statistics;
+
+    rb_nativethread_lock_lock(&rb_grn_query_statistics_lock);
+    n_statistics = rb_grn_query_statistics_size;
+    snapshot = malloc(sizeof(QueryStatistics) * (n_statistics + 1));
+    if (snapshot) {
+        for (i = 0; i < n_statistics; i++) {
+            snapshot[i] = *(rb_grn_query_statistics[i]);
+        }
+    }
+    rb_nativethread_lock_unlock(&rb_grn_query_statistics_lock);
+    if (!snapshot) {
+        rb_raise(rb_eNoMemError, "failed to allocate query statistics");
+    }
+
+    for (i = 0; i < n_statistics; i++) {
+        VALUE rb_command;
+        VALUE rb_command_statistics;
+
+        rb_command = rb_str_new_cstr(snapshot[i].command);
+        rb_command_statistics = rb_hash_aref(rb_statistics, rb_command);
+        if (NIL_P(rb_command_statistics)) {
+            rb_command_statistics = rb_hash_new();
+            rb_hash_aset(rb_statistics, rb_command, rb_command_statistics);
+        }
+        rb_hash_aset(rb_command_statistics,
+                     rb_str_new_cstr(snapshot[i].stage),
+                     rb_grn_query_statistics_to_ruby_object(&(snapshot[i])));
+    }
+    free(snapshot);
+#endif
+
+    return rb_statistics;
+}
+
+/*
+ * Clears all collected query statistics.
+ *
+ * @overload reset_statistics
+ *   @return [void]
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_query_logger_s_reset_statistics (VALUE klass)
+{
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    QueryStatistics **statistics;
+    size_t i, n_statistics;
+
+    rb_nativethread_lock_lock(&rb_grn_query_statistics_lock);
+    statistics = rb_grn_query_statistics;
+    n_statistics = rb_grn_query_statistics_size;
+    rb_grn_query_statistics = NULL;
+    rb_grn_query_statistics_size = 0;
+    rb_grn_query_statistics_capacity = 0;
+    rb_grn_query_n_running_commands = 0;
+    rb_nativethread_lock_unlock(&rb_grn_query_statistics_lock);
+
+    for (i = 0; i < n_statistics; i++) {
+        free(statistics[i]);
+    }
+    free(statistics);
+#endif
+
+    return Qnil;
+}
+
+typedef struct {
+    VALUE handler;
+    unsigned int flag;
+    const char *timestamp;
+    const char *info;
+    const char *message;
+} LogData;
+
+static void *
+rb_grn_query_logger_log_with_gvl (void *user_data)
+{
+    LogData *data = user_data;
+
+    /* TODO: use rb_protect(). */
+    rb_funcall(data->handler, id_log, 4,
+               GRNQUERYLOGFLAGS2RVAL(data->flag),
+               rb_str_new_cstr(data->timestamp),
+               rb_str_new_cstr(data->info),
+               rb_str_new_cstr(data->message));
+
+    return NULL;
+}
+
 static void
 rb_grn_query_logger_log (grn_ctx *ctx, unsigned int flag,
                          const char *timestamp, const char *info,
                          const char *message, void *user_data)
 {
     VALUE handler = (VALUE)user_data;
+    LogData data;
+
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    if (rb_grn_query_statistics_enabled) {
+        rb_grn_query_statistics_update(ctx, info, message);
+    }
+#endif
 
     if (NIL_P(handler))
         return;
 
-    /* TODO: use rb_protect(). */
-    rb_funcall(handler, id_log, 4,
-               GRNQUERYLOGFLAGS2RVAL(flag),
-               rb_str_new_cstr(timestamp),
-               rb_str_new_cstr(info),
-               rb_str_new_cstr(message));
+    if ((flag & rb_grn_query_logger_statistics_only_flags) &&
+        !(flag & ~rb_grn_query_logger_statistics_only_flags))
+        return;
+
+    data.handler = handler;
+    data.flag = flag;
+    data.timestamp = timestamp;
+    data.info = info;
+    data.message = message;
+    /* This may be called while Groonga is running without the GVL. */
+    rb_grn_context_call_with_gvl(rb_grn_query_logger_log_with_gvl, &data);
 }
 
 static void
@@ -167,14 +631,38 @@ rb_grn_query_logger_fin (grn_ctx *ctx, void *user_data)
  *       Flags describe what query log should be logged.
  *
  *       If `flags` is String, it is parsed by {QueryLogger::Flags.parse}.
+ *     @option options [Bool] :statistics (false)
+ *       If it's `true`, query log entries are parsed in C and the
+ *       elapsed time of each command and stage is recorded to
+ *       histograms. See {QueryLogger.statistics}. `logger` can be
+ *       `nil` to collect only statistics.
+ *
+ *       Command, result code and size entries are always requested
+ *       to Groonga for statistics. But `logger` only receives entries
+ *       that match `flags`.
+ *
+ *       It's available since 15.0.5.
+ *     @option options [Float] :sampling_rate (1.0)
+ *       The ratio of commands that are recorded to statistics. For
+ *       example, `0.1` records about 10% commands.
+ *
+ *       It's available since 15.0.5.
  *
  *   @return void
  *
  * @overload register(options={})
+ *   @example Register a callback with options
+ *     Groonga::QueryLogger.register(:statistics => true) do |*args|
+ *       p args
+ *     end
+ *
  *   @yield [action, flag, timestamp, info, message]
  *     ...
  *
  *   @!macro query-logger.register.options
+ *
+ *   `options` are used with a block since 15.0.5. They were ignored
+ *   before 15.0.5.
  */
 static VALUE
 rb_grn_query_logger_s_register (int argc, VALUE *argv, VALUE klass)
@@ -184,11 +672,17 @@ rb_grn_query_logger_s_register (int argc, VALUE *argv, VALUE klass)
     VALUE rb_logger, rb_callback;
     VALUE rb_options, rb_command, rb_result_code, rb_destination;
     VALUE rb_cache, rb_size, rb_score, rb_default, rb_all, rb_flags;
+    VALUE rb_statistics, rb_sampling_rate;
     unsigned int flags = GRN_QUERY_LOG_NONE;
+    grn_bool statistics;
+    double sampling_rate = 1.0;
 
     rb_scan_args(argc, argv, "02&", &rb_logger, &rb_options, &rb_callback);
 
     if (rb_block_given_p()) {
+        if (RB_TYPE_P(rb_logger, RUBY_T_HASH)) {
+            rb_options = rb_logger;
+        }
         rb_logger = rb_funcall(cGrnCallbackQueryLogger, id_new, 1, rb_callback);
     }
 
@@ -202,8 +696,26 @@ rb_grn_query_logger_s_register (int argc, VALUE *argv, VALUE klass)
                         "default",     &rb_default,
                         "all",         &rb_all,
                         "flags",       &rb_flags,
+                        "statistics",  &rb_statistics,
+                        "sampling_rate", &rb_sampling_rate,
                         NULL);
 
+    statistics = RVAL2CBOOL(rb_statistics);
+#ifndef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    if (statistics) {
+        rb_raise(rb_eNotImpError,
+                 "query statistics requires ruby/thread_native.h");
+    }
+#endif
+    if (!NIL_P(rb_sampling_rate)) {
+        sampling_rate = NUM2DBL(rb_sampling_rate);
+        if (!(0.0 <= sampling_rate && sampling_rate <= 1.0)) {
+            rb_raise(rb_eArgError,
+                     "sampling rate must be 0.0..1.0: %" PRIsVALUE,
+                     rb_sampling_rate);
+        }
+    }
+
     if (RVAL2CBOOL(rb_command)) {
         flags |= GRN_QUERY_LOG_COMMAND;
     }
@@ -229,10 +741,30 @@ rb_grn_query_logger_s_register (int argc, VALUE *argv, VALUE klass)
         flags |= GRN_QUERY_LOG_ALL;
     }
     if (!NIL_P(rb_flags)) {
-        flags = rb_funcall(mGrnQueryLoggerFlags, id_parse, 2,
-                           rb_flags, UINT2NUM(flags));
+        flags = NUM2UINT(rb_funcall(mGrnQueryLoggerFlags, id_parse, 2,
+                                    rb_flags, UINT2NUM(flags)));
     }
 
+    rb_grn_query_logger_statistics_only_flags = GRN_QUERY_LOG_NONE;
+    if (statistics) {
+        /* Statistics need command, stage and end entries. They are
+         * requested to Groonga but they aren't passed to the logger
+         * when the logger doesn't request them. */
+        unsigned int statistics_flags =
+            GRN_QUERY_LOG_COMMAND |
+            GRN_QUERY_LOG_RESULT_CODE |
+            GRN_QUERY_LOG_SIZE;
+        rb_grn_query_logger_statistics_only_flags = statistics_flags & ~flags;
+        flags |= statistics_flags;
+    }
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    rb_nativethread_lock_lock(&rb_grn_query_statistics_lock);
+    rb_grn_query_statistics_enabled = statistics;
+    rb_grn_query_statistics_sampling_rate = sampling_rate;
+    rb_grn_query_n_running_commands = 0;
+    rb_nativethread_lock_unlock(&rb_grn_query_statistics_lock);
+#endif
+
     rb_grn_query_logger.flags     = flags;
     rb_grn_query_logger.user_data = (void *)rb_logger;
 
@@ -252,9 +784,15 @@ rb_grn_query_logger_s_unregister (VALUE klass)
     grn_ctx *context;
 
     current_logger = rb_cv_get(klass, "@@current_logger");
-    if (NIL_P(current_logger))
+    if (NIL_P(current_logger) && !rb_grn_query_statistics_enabled)
         return Qnil;
 
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    rb_nativethread_lock_lock(&rb_grn_query_statistics_lock);
+    rb_grn_query_statistics_enabled = GRN_FALSE;
+    rb_grn_query_n_running_commands = 0;
+    rb_nativethread_lock_unlock(&rb_grn_query_statistics_lock);
+#endif
     rb_cv_set(klass, "@@current_logger", Qnil);
 
     context = rb_grn_context_ensure(&rb_context);
@@ -457,6 +995,10 @@ rb_grn_init_query_logger (VALUE mGrn)
     id_reopen = rb_intern("reopen");
     id_fin    = rb_intern("fin");
 
+#ifdef RB_GRN_QUERY_LOGGER_STATISTICS_AVAILABLE
+    rb_nativethread_lock_initialize(&rb_grn_query_statistics_lock);
+#endif
+
     rb_grn_query_logger.log    = rb_grn_query_logger_log;
     rb_grn_query_logger.reopen = rb_grn_query_logger_reopen;
     rb_grn_query_logger.fin    = rb_grn_query_logger_fin;
@@ -474,6 +1016,10 @@ rb_grn_init_query_logger (VALUE mGrn)
                                rb_grn_query_logger_s_unregister, 0);
     rb_define_singleton_method(cGrnQueryLogger, "reopen",
                                rb_grn_query_logger_s_reopen, 0);
+    rb_define_singleton_method(cGrnQueryLogger, "statistics",
+                               rb_grn_query_logger_s_get_statistics, 0);
+    rb_define_singleton_method(cGrnQueryLogger, "reset_statistics",
+                               rb_grn_query_logger_s_reset_statistics, 0);
     rb_define_singleton_method(cGrnQueryLogger, "path",
                                rb_grn_query_logger_s_get_path, 0);
     rb_define_singleton_method(cGrnQueryLogger, "path=",
@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2021  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 
   This library is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
@@ -266,6 +266,210 @@ rb_grn_snippet_execute (VALUE self, VALUE rb_string)
     return rb_results;
 }
 
+typedef struct {
+    VALUE self;
+    grn_ctx *context;
+    grn_obj *snippet;
+    grn_obj *column;
+    grn_obj value;
+    char *result;
+    unsigned int result_size;
+} ExecuteForData;
+
+static VALUE
+rb_grn_snippet_execute_for_record (ExecuteForData *data, grn_id id)
+{
+    grn_ctx *context = data->context;
+    grn_rc rc;
+    unsigned int i, n_results, max_tagged_length;
+    VALUE rb_results;
+
+    GRN_BULK_REWIND(&(data->value));
+    grn_obj_get_value(context, data->column, id, &(data->value));
+    rb_grn_context_check(context, data->self);
+    if (GRN_TEXT_LEN(&(data->value)) == 0) {
+        return rb_ary_new();
+    }
+
+    rc = grn_snip_exec(context, data->snippet,
+                       GRN_TEXT_VALUE(&(data->value)),
+                       GRN_TEXT_LEN(&(data->value)),
+                       &n_results, &max_tagged_length);
+    rb_grn_context_check(context, data->self);
+    rb_grn_rc_check(rc, data->self);
+
+    if (max_tagged_length > data->result_size) {
+        REALLOC_N(data->result, char, max_tagged_length);
+        data->result_size = max_tagged_length;
+    }
+    rb_results = rb_ary_new2(n_results);
+    for (i = 0; i < n_results; i++) {
+        unsigned result_length;
+
+        rc = grn_snip_get_result(context, data->snippet,
+                                 i, data->result, &result_length);
+        rb_grn_rc_check(rc, data->self);
+        rb_ary_push(rb_results,
+                    rb_grn_context_rb_string_new(context,
+                                                 data->result,
+                                                 result_length));
+    }
+
+    return rb_results;
+}
+
+typedef struct {
+    ExecuteForData *data;
+    VALUE rb_records;
+    grn_obj *table;
+} ExecuteForBodyData;
+
+static VALUE
+rb_grn_snippet_execute_for_body (VALUE user_data)
+{
+    ExecuteForBodyData *body_data = (ExecuteForBodyData *)user_data;
+    ExecuteForData *data = body_data->data;
+    grn_ctx *context = data->context;
+    VALUE rb_results;
+
+    if (NIL_P(body_data->rb_records)) {
+        grn_table_cursor *cursor;
+        grn_id id;
+
+        rb_results = rb_ary_new2(grn_table_size(context, body_data->table));
+        cursor = grn_table_cursor_open(context, body_data->table,
+                                       NULL, 0, NULL, 0,
+                                       0, -1, GRN_CURSOR_ASCENDING);
+        rb_grn_context_check(context, data->self);
+        while ((id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+            rb_ary_push(rb_results,
+                        rb_grn_snippet_execute_for_record(data, id));
+        }
+        grn_table_cursor_close(context, cursor);
+    } else {
+        long i, n_records;
+
+        n_records = RARRAY_LEN(body_data->rb_records);
+        rb_results = rb_ary_new2(n_records);
+        for (i = 0; i < n_records; i++) {
+            grn_id id;
+
+            id = RVAL2GRNID(RARRAY_AREF(body_data->rb_records, i),
+                            context,
+                            body_data->table,
+                            data->self);
+            rb_ary_push(rb_results,
+                        rb_grn_snippet_execute_for_record(data, id));
+        }
+    }
+
+    return rb_results;
+}
+
+static VALUE
+rb_grn_snippet_execute_for_ensure (VALUE user_data)
+{
+    ExecuteForBodyData *body_data = (ExecuteForBodyData *)user_data;
+    ExecuteForData *data = body_data->data;
+
+    GRN_OBJ_FIN(data->context, &(data->value));
+    xfree(data->result);
+
+    return Qnil;
+}
+
+/*
+ * Creates snippets for the `column` value of each record in
+ * `records`.
+ *
+ * It's faster than calling {#execute} with `record[column]` for each
+ * record. Values are read in C without creating Ruby objects and
+ * they aren't re-encoded because they're already in the database
+ * encoding. The buffer for tagged snippets is reused for all records.
+ *
+ * @example Highlight titles of the first 100 hits
+ *   hits = entries.select {|record| record.title =~ "Groonga"}
+ *   sorted_hits = hits.sort(["_score"], :limit => 100)
+ *   snippet = Groonga::Snippet.new(:default_open_tag => "<em>",
+ *                                  :default_close_tag => "</em>")
+ *   snippet.add_keyword("Groonga")
+ *   snippet.execute_for(sorted_hits, "title").each do |snippets|
+ *     p snippets
+ *   end
+ *
+ * @overload execute_for(records, column, options={})
+ *   @param records [Groonga::Table, ::Array<Groonga::Record, Integer>]
+ *     The target records. If it's a table, all records in the table
+ *     are used in the table order. If it's an Array, all records must
+ *     belong to the same table. Record IDs can be used instead of
+ *     {Groonga::Record}s with `:table`.
+ *   @param column [String, Symbol, Groonga::Column] The column to be
+ *     scanned. Its value must be text.
+ *   @param options [::Hash] The optional parameters.
+ *   @option options :table [Groonga::Table] (nil) The table of
+ *     `records` when `records` is an Array. It's required when the
+ *     first element of `records` isn't a {Groonga::Record}.
+ *   @return [::Array<::Array<String>>] The snippets for each record in
+ *     the same order as `records`.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_snippet_execute_for (int argc, VALUE *argv, VALUE self)
+{
+    ExecuteForData data;
+    ExecuteForBodyData body_data;
+    VALUE rb_records, rb_column, rb_options;
+    VALUE rb_table;
+
+    rb_scan_args(argc, argv, "21", &rb_records, &rb_column, &rb_options);
+    rb_grn_scan_options(rb_options,
+                        "table", &rb_table,
+                        NULL);
+
+    rb_grn_snippet_deconstruct(SELF(self), &(data.snippet), &(data.context));
+
+    if (RVAL2CBOOL(rb_obj_is_kind_of(rb_records, rb_cGrnTable))) {
+        rb_table = rb_records;
+        body_data.rb_records = Qnil;
+    } else {
+        body_data.rb_records = rb_grn_convert_to_array(rb_records);
+        if (RARRAY_LEN(body_data.rb_records) == 0) {
+            return rb_ary_new();
+        }
+        if (NIL_P(rb_table)) {
+            VALUE rb_first_record = RARRAY_AREF(body_data.rb_records, 0);
+            if (!RVAL2CBOOL(rb_obj_is_kind_of(rb_first_record,
+                                              rb_cGrnRecord))) {
+                rb_raise(rb_eArgError,
+                         ":table is required for record IDs: %" PRIsVALUE,
+                         rb_first_record);
+            }
+            rb_table = rb_funcall(rb_first_record, rb_intern("table"), 0);
+        }
+    }
+    body_data.table = RVAL2GRNOBJECT(rb_table, &(data.context));
+
+    if (RVAL2CBOOL(rb_obj_is_kind_of(rb_column, rb_cString)) ||
+        RVAL2CBOOL(rb_obj_is_kind_of(rb_column, rb_cSymbol))) {
+        rb_column = rb_grn_table_get_column_surely(rb_table, rb_column);
+    }
+    data.column = RVAL2GRNOBJECT(rb_column, &(data.context));
+    if (grn_obj_is_vector_column(data.context, data.column)) {
+        rb_raise(rb_eArgError,
+                 "vector column isn't supported: %" PRIsVALUE,
+                 rb_column);
+    }
+
+    data.self = self;
+    data.result = NULL;
+    data.result_size = 0;
+    GRN_TEXT_INIT(&(data.value), 0);
+    body_data.data = &data;
+    return rb_ensure(rb_grn_snippet_execute_for_body, (VALUE)&body_data,
+                     rb_grn_snippet_execute_for_ensure, (VALUE)&body_data);
+}
+
 void
 rb_grn_init_snippet (VALUE mGrn)
 {
@@ -277,4 +481,6 @@ rb_grn_init_snippet (VALUE mGrn)
                      rb_grn_snippet_add_keyword, -1);
     rb_define_method(rb_cGrnSnippet, "execute",
                      rb_grn_snippet_execute, 1);
+    rb_define_method(rb_cGrnSnippet, "execute_for",
+                     rb_grn_snippet_execute_for, -1);
 }
@@ -0,0 +1,603 @@
+/* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim: set sts=4 sw=4 ts=8 noet: */
+/*
+  Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License version 2.1 as published by the Free Software Foundation.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "rb-grn.h"
+
+#include <math.h>
+
+/*
+ * Document-class: Groonga::TableDumper
+ *
+ * The native part of {Groonga::TableDumper}. It writes records as
+ * JSON without creating a Ruby object for each value.
+ */
+
+#define RB_GRN_TABLE_DUMPER_FLUSH_SIZE (64 * 1024)
+#define RB_GRN_TABLE_DUMPER_MAX_REFERENCE_DEPTH 8
+
+static ID id_write;
+static ID id_open_cursor;
+static ID id_name;
+static ID id_local_name;
+static ID id_to_s;
+static ID id_to_json;
+static ID id_record_id;
+
+typedef struct {
+    grn_ctx *context;
+    VALUE rb_table;
+    VALUE rb_table_name;
+    VALUE rb_output;
+    VALUE rb_error_output;
+    VALUE rb_columns;
+    VALUE rb_column_names;
+    VALUE rb_order_by;
+    VALUE rb_limit;
+    VALUE rb_cursor;
+    VALUE rb_buffer;
+    rb_encoding *encoding;
+    int n_columns;
+    grn_obj **columns;
+    grn_id *ranges;
+    grn_obj *values;
+    grn_id id;
+    int column_index;
+} DumpRecordsData;
+
+static grn_bool
+rb_grn_table_dumper_is_supported_range (grn_ctx *context, grn_id range_id)
+{
+    int depth;
+
+    for (depth = 0; depth < RB_GRN_TABLE_DUMPER_MAX_REFERENCE_DEPTH; depth++) {
+        grn_obj *range;
+
+        switch (range_id) {
+        case GRN_DB_BOOL:
+        case GRN_DB_INT8:
+        case GRN_DB_UINT8:
+        case GRN_DB_INT16:
+        case GRN_DB_UINT16:
+        case GRN_DB_INT32:
+        case GRN_DB_UINT32:
+        case GRN_DB_INT64:
+        case GRN_DB_UINT64:
+        case GRN_DB_FLOAT:
+#if RB_GRN_HAVE_FLOAT32
+        case GRN_DB_FLOAT32:
+#endif
+        case GRN_DB_TIME:
+        case GRN_DB_SHORT_TEXT:
+        case GRN_DB_TEXT:
+        case GRN_DB_LONG_TEXT:
+            return GRN_TRUE;
+        default:
+            break;
+        }
+
+        range = grn_ctx_at(context, range_id);
+        if (!range || !grn_obj_is_table(context, range))
+            return GRN_FALSE;
+        if (range->header.type == GRN_TABLE_NO_KEY)
+            return GRN_TRUE;
+        range_id = range->header.domain;
+    }
+
+    return GRN_FALSE;
+}
+
+static void
+rb_grn_table_dumper_flush (DumpRecordsData *data)
+{
+    if (RSTRING_LEN(data->rb_buffer) == 0)
+        return;
+
+    rb_funcall(data->rb_output, id_write, 1, data->rb_buffer);
+    data->rb_buffer = rb_enc_str_new(NULL, 0, data->encoding);
+}
+
+static void
+rb_grn_table_dumper_write (DumpRecordsData *data,
+                           const char *content, long content_size)
+{
+    rb_str_cat(data->rb_buffer, content, content_size);
+}
+
+#define WRITE_LITERAL(data, literal)                                    \
+    rb_grn_table_dumper_write((data), (literal), sizeof(literal) - 1)
+
+static void
+rb_grn_table_dumper_write_rb_string (DumpRecordsData *data, VALUE rb_string)
+{
+    rb_grn_table_dumper_write(data,
+                              RSTRING_PTR(rb_string),
+                              RSTRING_LEN(rb_string));
+}
+
+static void
+rb_grn_table_dumper_write_float (DumpRecordsData *data, double value)
+{
+    VALUE rb_value = rb_float_new(value);
+
+    /* Float#to_json raises for NaN and Infinity. Use it for them to
+     * report the same error as the Ruby implementation. */
+    if (isfinite(value)) {
+        rb_grn_table_dumper_write_rb_string(data,
+                                            rb_funcall(rb_value, id_to_s, 0));
+    } else {
+        rb_grn_table_dumper_write_rb_string(data,
+                                            rb_funcall(rb_value, id_to_json, 0));
+    }
+}
+
+static void
+rb_grn_table_dumper_warn_invalid_character (DumpRecordsData *data,
+                                            const char *start,
+                                            const char *invalid_character)
+{
+    VALUE rb_message;
+    VALUE rb_sanitized;
+    const char *current;
+    unsigned char byte;
+    char inspected_byte[8];
+
+    if (NIL_P(data->rb_error_output))
+        return;
+
+    rb_sanitized = rb_enc_str_new(NULL, 0, data->encoding);
+    current = start;
+    while (current < invalid_character) {
+        int length;
+
+        length = rb_enc_precise_mbclen(current, invalid_character,
+                                       data->encoding);
+        if (MBCLEN_CHARFOUND_P(length)) {
+            rb_str_cat(rb_sanitized, current, MBCLEN_CHARFOUND_LEN(length));
+            current += MBCLEN_CHARFOUND_LEN(length);
+        } else {
+            current++;
+        }
+    }
+
+    /* The same format as "%#0x" % byte in Ruby. */
+    byte = (unsigned char)(*invalid_character);
+    if (byte == 0) {
+        snprintf(inspected_byte, sizeof(inspected_byte), "0");
+    } else {
+        snprintf(inspected_byte, sizeof(inspected_byte), "0x%x", byte);
+    }
+
+    rb_message = rb_enc_str_new_cstr("warning: ignore invalid encoding character: <",
+                                     data->encoding);
+    rb_str_append(rb_message, rb_obj_as_string(data->rb_table_name));
+    /* The same as Groonga::Record#record_id: the key for keyed
+     * tables and the ID for others. */
+    rb_str_cat_cstr(rb_message, "[");
+    rb_str_append(rb_message,
+                  rb_obj_as_string(
+                      rb_funcall(rb_grn_record_new(data->rb_table,
+                                                   data->id,
+                                                   Qnil),
+                                 id_record_id,
+                                 0)));
+    rb_str_cat_cstr(rb_message, "].");
+    rb_str_append(rb_message,
+                  RARRAY_AREF(data->rb_column_names, data->column_index));
+    rb_str_cat_cstr(rb_message, ">: <");
+    rb_str_cat_cstr(rb_message, inspected_byte);
+    rb_str_cat_cstr(rb_message, ">: before: <");
+    rb_str_append(rb_message, rb_sanitized);
+    rb_str_cat_cstr(rb_message, ">\n");
+    rb_funcall(data->rb_error_output, id_write, 1, rb_message);
+}
+
+static void
+rb_grn_table_dumper_write_string (DumpRecordsData *data,
+                                  const char *value,
+                                  unsigned int value_size)
+{
+    const char *current = value;
+    const char *end = value + value_size;
+    const char *chunk_start = value;
+
+    WRITE_LITERAL(data, "\"");
+    while (current < end) {
+        unsigned char byte = (unsigned char)(*current);
+        const char *escaped = NULL;
+        char escaped_control[7];
+        int length;
+
+        if (byte >= 0x20 && byte < 0x80 && byte != '"' && byte != '\\') {
+            current++;
+            continue;
+        }
+
+        if (byte < 0x80) {
+            switch (byte) {
+            case '"':
+                escaped = "\\\"";
+                break;
+            case '\\':
+                escaped = "\\\\";
+                break;
+            case '\b':
+                escaped = "\\b";
+                break;
+            case '\f':
+                escaped = "\\f";
+                break;
+            case '\n':
+                escaped = "\\n";
+                break;
+            case '\r':
+                escaped = "\\r";
+                break;
+            case '\t':
+                escaped = "\\t";
+                break;
+            default:
+                snprintf(escaped_control, sizeof(escaped_control),
+                         "\\u%04x", byte);
+                escaped = escaped_control;
+                break;
+            }
+            rb_grn_table_dumper_write(data, chunk_start, current - chunk_start);
+            rb_grn_table_dumper_write(data, escaped, strlen(escaped));
+            current++;
+            chunk_start = current;
+            continue;
+        }
+
+        length = rb_enc_precise_mbclen(current, end, data->encoding);
+        if (MBCLEN_CHARFOUND_P(length)) {
+            current += MBCLEN_CHARFOUND_LEN(length);
+            continue;
+        }
+
+        /* String#each_char treats each byte in an invalid byte
+         * sequence as one character. */
+        rb_grn_table_dumper_write(data, chunk_start, current - chunk_start);
+        rb_grn_table_dumper_warn_invalid_character(data, value, current);
+        current++;
+        chunk_start = current;
+    }
+    rb_grn_table_dumper_write(data, chunk_start, current - chunk_start);
+    WRITE_LITERAL(data, "\"");
+}
+
+static void
+rb_grn_table_dumper_write_value (DumpRecordsData *data,
+                                 const char *value,
+                                 unsigned int value_size,
+                                 grn_id range_id,
+                                 int depth)
+{
+    grn_ctx *context = data->context;
+    char number[32];
+
+    /* The Ruby implementation dumps nil as "". */
+    if (value_size == 0) {
+        WRITE_LITERAL(data, "\"\"");
+        return;
+    }
+
+    switch (range_id) {
+    case GRN_DB_BOOL:
+        if (*((grn_bool *)value)) {
+            WRITE_LITERAL(data, "true");
+        } else {
+            WRITE_LITERAL(data, "false");
+        }
+        return;
+    case GRN_DB_INT8:
+        snprintf(number, sizeof(number), "%d", *((int8_t *)value));
+        break;
+    case GRN_DB_UINT8:
+        snprintf(number, sizeof(number), "%u", *((uint8_t *)value));
+        break;
+    case GRN_DB_INT16:
+        snprintf(number, sizeof(number), "%d", *((int16_t *)value));
+        break;
+    case GRN_DB_UINT16:
+        snprintf(number, sizeof(number), "%u", *((uint16_t *)value));
+        break;
+    case GRN_DB_INT32:
+        snprintf(number, sizeof(number), "%d", *((int32_t *)value));
+        break;
+    case GRN_DB_UINT32:
+        snprintf(number, sizeof(number), "%u", *((uint32_t *)value));
+        break;
+    case GRN_DB_INT64:
+        snprintf(number, sizeof(number), "%lld",
+                 (long long)(*((int64_t *)value)));
+        break;
+    case GRN_DB_UINT64:
+        snprintf(number, sizeof(number), "%llu",
+                 (unsigned long long)(*((uint64_t *)value)));
+        break;
+    case GRN_DB_FLOAT:
+        rb_grn_table_dumper_write_float(data, *((double *)value));
+        return;
+#if RB_GRN_HAVE_FLOAT32
+    case GRN_DB_FLOAT32:
+        rb_grn_table_dumper_write_float(data, *((float *)value));
+        return;
+#endif
+    case GRN_DB_TIME:
+        /* Time#to_f divides nanoseconds by 1e9. Use the same
+         * computation to get the same value. */
+        rb_grn_table_dumper_write_float(data,
+                                        (double)(*((int64_t *)value) * 1000) /
+                                        1e9);
+        return;
+    case GRN_DB_SHORT_TEXT:
+    case GRN_DB_TEXT:
+    case GRN_DB_LONG_TEXT:
+        rb_grn_table_dumper_write_string(data, value, value_size);
+        return;
+    default:
+    {
+        grn_obj *range;
+        grn_id id;
+        char key[GRN_TABLE_MAX_KEY_SIZE];
+        int key_size;
+
+        range = grn_ctx_at(context, range_id);
+        id = *((grn_id *)value);
+        if (id == GRN_ID_NIL) {
+            WRITE_LITERAL(data, "\"\"");
+            return;
+        }
+        if (range->header.type == GRN_TABLE_NO_KEY ||
+            depth >= RB_GRN_TABLE_DUMPER_MAX_REFERENCE_DEPTH) {
+            snprintf(number, sizeof(number), "%u", id);
+            break;
+        }
+        key_size = grn_table_get_key(context, range, id, key, sizeof(key));
+        rb_grn_table_dumper_write_value(data,
+                                        key,
+                                        key_size,
+                                        range->header.domain,
+                                        depth + 1);
+        return;
+    }
+    }
+
+    rb_grn_table_dumper_write(data, number, strlen(number));
+}
+
+static void
+rb_grn_table_dumper_write_column_value (DumpRecordsData *data)
+{
+    grn_ctx *context = data->context;
+    grn_obj *value = &(data->values[data->column_index]);
+    grn_id range_id = data->ranges[data->column_index];
+
+    switch (value->header.type) {
+    case GRN_UVECTOR:
+    {
+        unsigned int i, n, element_size;
+        const char *head;
+
+        element_size = grn_uvector_element_size(context, value);
+        n = grn_uvector_size(context, value);
+        head = GRN_BULK_HEAD(value);
+        WRITE_LITERAL(data, "[");
+        for (i = 0; i < n; i++) {
+            if (i > 0)
+                WRITE_LITERAL(data, ",");
+            rb_grn_table_dumper_write_value(data,
+                                            head + (element_size * i),
+                                            element_size,
+                                            range_id,
+                                            0);
+        }
+        WRITE_LITERAL(data, "]");
+        break;
+    }
+    case GRN_VECTOR:
+    {
+        unsigned int i, n;
+
+        n = grn_vector_size(context, value);
+        WRITE_LITERAL(data, "[");
+        for (i = 0; i < n; i++) {
+            const char *element;
+            unsigned int element_size;
+            grn_id domain;
+
+            if (i > 0)
+                WRITE_LITERAL(data, ",");
+            element_size = grn_vector_get_element(context, value, i,
+                                                  &element, NULL, &domain);
+            rb_grn_table_dumper_write_value(data,
+                                            element,
+                                            element_size,
+                                            domain,
+                                            0);
+        }
+        WRITE_LITERAL(data, "]");
+        break;
+    }
+    default:
+        rb_grn_table_dumper_write_value(data,
+                                        GRN_BULK_HEAD(value),
+                                        GRN_BULK_VSIZE(value),
+                                        range_id,
+                                        0);
+        break;
+    }
+}
+
+static VALUE
+rb_grn_table_dumper_dump_records_body (VALUE user_data)
+{
+    DumpRecordsData *data = (DumpRecordsData *)user_data;
+    grn_ctx *context;
+    grn_table_cursor *cursor;
+    VALUE rb_options;
+    int i;
+
+    for (i = 0; i < data->n_columns; i++) {
+        VALUE rb_column = RARRAY_AREF(data->rb_columns, i);
+        grn_obj *column;
+
+        column = RVAL2GRNOBJECT(rb_column, &(data->context));
+        data->columns[i] = column;
+        data->ranges[i] = grn_obj_get_range(data->context, column);
+        grn_obj_reinit_for(data->context, &(data->values[i]), column);
+        rb_ary_push(data->rb_column_names,
+                    rb_funcall(rb_column, id_local_name, 0));
+    }
+    context = data->context;
+
+    rb_options = rb_hash_new();
+    rb_hash_aset(rb_options, RB_GRN_INTERN("order_by"), data->rb_order_by);
+    rb_hash_aset(rb_options, RB_GRN_INTERN("limit"), data->rb_limit);
+    data->rb_cursor = rb_funcall(data->rb_table, id_open_cursor, 1, rb_options);
+    cursor = RVAL2GRNTABLECURSOR(data->rb_cursor, &context);
+
+    data->rb_buffer = rb_enc_str_new(NULL, 0, data->encoding);
+    while ((data->id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+        WRITE_LITERAL(data, ",\n[");
+        for (i = 0; i < data->n_columns; i++) {
+            grn_obj *value = &(data->values[i]);
+
+            if (i > 0)
+                WRITE_LITERAL(data, ",");
+            GRN_BULK_REWIND(value);
+            grn_obj_get_value(context, data->columns[i], data->id, value);
+            data->column_index = i;
+            rb_grn_table_dumper_write_column_value(data);
+        }
+        WRITE_LITERAL(data, "]");
+        if (RSTRING_LEN(data->rb_buffer) >= RB_GRN_TABLE_DUMPER_FLUSH_SIZE)
+            rb_grn_table_dumper_flush(data);
+    }
+    rb_grn_table_dumper_flush(data);
+
+    return Qtrue;
+}
+
+static VALUE
+rb_grn_table_dumper_dump_records_ensure (VALUE user_data)
+{
+    DumpRecordsData *data = (DumpRecordsData *)user_data;
+    int i;
+
+    if (!NIL_P(data->rb_cursor))
+        rb_grn_object_close(data->rb_cursor);
+    for (i = 0; i < data->n_columns; i++) {
+        GRN_OBJ_FIN(data->context, &(data->values[i]));
+    }
+    xfree(data->columns);
+    xfree(data->ranges);
+    xfree(data->values);
+
+    return Qnil;
+}
+
+/*
+ * Dumps records as JSON arrays without creating Ruby objects for
+ * each value. It returns `false` without writing anything when the
+ * table has a value that can't be dumped natively. The caller must
+ * use the Ruby implementation in the case.
+ *
+ * @overload dump_records_native(columns, order_by, limit)
+ *   @param columns [::Array<Groonga::Column>] The columns to be dumped.
+ *   @param order_by [Symbol, nil] The order passed to
+ *     {Groonga::Table#open_cursor}.
+ *   @param limit [Integer, nil] The max number of records to be dumped.
+ *   @return [Boolean] `true` if records are dumped, `false` otherwise.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_table_dumper_dump_records_native (VALUE self,
+                                         VALUE rb_columns,
+                                         VALUE rb_order_by,
+                                         VALUE rb_limit)
+{
+    DumpRecordsData data;
+    grn_ctx *context = NULL;
+    int i, n_columns;
+
+    data.rb_table = rb_iv_get(self, "@table");
+    RVAL2GRNTABLE(data.rb_table, &context);
+    if (context->encoding != GRN_ENC_UTF8)
+        return Qfalse;
+
+    rb_columns = rb_grn_convert_to_array(rb_columns);
+    n_columns = RARRAY_LEN(rb_columns);
+    for (i = 0; i < n_columns; i++) {
+        grn_obj *column;
+
+        column = RVAL2GRNOBJECT(RARRAY_AREF(rb_columns, i), &context);
+        if (grn_obj_is_column(context, column) &&
+            (column->header.flags & GRN_OBJ_WITH_WEIGHT))
+            return Qfalse;
+        if (!rb_grn_table_dumper_is_supported_range(context,
+                                                    grn_obj_get_range(context,
+                                                                      column)))
+            return Qfalse;
+    }
+
+    data.context = context;
+    data.rb_table_name = rb_funcall(data.rb_table, id_name, 0);
+    data.rb_output = rb_iv_get(self, "@output");
+    data.rb_error_output = rb_iv_get(self, "@error_output");
+    data.rb_columns = rb_columns;
+    data.rb_column_names = rb_ary_new_capa(n_columns);
+    data.rb_order_by = rb_order_by;
+    data.rb_limit = rb_limit;
+    data.rb_cursor = Qnil;
+    data.rb_buffer = Qnil;
+    data.encoding = rb_utf8_encoding();
+    data.columns = ALLOC_N(grn_obj *, n_columns);
+    data.ranges = ALLOC_N(grn_id, n_columns);
+    data.values = ALLOC_N(grn_obj, n_columns);
+    data.n_columns = n_columns;
+    for (i = 0; i < n_columns; i++) {
+        GRN_VOID_INIT(&(data.values[i]));
+    }
+    data.id = GRN_ID_NIL;
+    data.column_index = 0;
+
+    return rb_ensure(rb_grn_table_dumper_dump_records_body, (VALUE)&data,
+                     rb_grn_table_dumper_dump_records_ensure, (VALUE)&data);
+}
+
+void
+rb_grn_init_table_dumper (VALUE mGrn)
+{
+    VALUE cGrnTableDumper;
+
+    CONST_ID(id_write, "write");
+    CONST_ID(id_open_cursor, "open_cursor");
+    CONST_ID(id_name, "name");
+    CONST_ID(id_local_name, "local_name");
+    CONST_ID(id_to_s, "to_s");
+    CONST_ID(id_to_json, "to_json");
+    CONST_ID(id_record_id, "record_id");
+
+    cGrnTableDumper = rb_define_class_under(mGrn, "TableDumper", rb_cObject);
+
+    rb_define_private_method(cGrnTableDumper, "dump_records_native",
+                             rb_grn_table_dumper_dump_records_native, 3);
+}
@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2022  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2014-2016  Masafumi Yokoyama <yokoyama@clear-code.com>
 
   This library is free software; you can redistribute it and/or
@@ -1052,6 +1052,187 @@ rb_grn_table_key_support_tokenize (int argc, VALUE *argv, VALUE self)
     return rb_tokens;
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    bool add_p;
+    long n_strings;
+    const char **strings;
+    unsigned int *string_sizes;
+    uint32_t *offsets;
+    grn_obj *string_tokens;
+    grn_obj *tokens;
+} TokenizeManyData;
+
+static void *
+rb_grn_table_key_support_tokenize_many_without_gvl (void *user_data)
+{
+    TokenizeManyData *data = user_data;
+    grn_ctx *context = data->context;
+    long i;
+
+    data->offsets[0] = 0;
+    for (i = 0; i < data->n_strings; i++) {
+        /* grn_table_tokenize() rewinds the output buffer. */
+        GRN_BULK_REWIND(data->string_tokens);
+        if (data->string_sizes[i] > 0) {
+            grn_table_tokenize(context, data->table,
+                               data->strings[i], data->string_sizes[i],
+                               data->string_tokens, data->add_p);
+            if (context->rc != GRN_SUCCESS) {
+                break;
+            }
+            grn_bulk_write(context, data->tokens,
+                           GRN_BULK_HEAD(data->string_tokens),
+                           GRN_BULK_VSIZE(data->string_tokens));
+        }
+        data->offsets[i + 1] =
+            GRN_BULK_VSIZE(data->tokens) / sizeof(grn_id);
+    }
+
+    return NULL;
+}
+
+/*
+ * Tokenizes many strings at once using the table as lexicon.
+ *
+ * It's faster than calling {#tokenize} for each string because
+ * {Groonga::Record} isn't created for each token by default.
+ * Token IDs are returned as packed binary strings. Each packed
+ * string has native endian unsigned 32bit integers. You can unpack
+ * it by `string.unpack("L*")` or wrap it by `IO::Buffer.for`.
+ *
+ * The GVL is released while strings are tokenized when the context
+ * is created with `release_gvl: true`.
+ *
+ * @example
+ *   ids, offsets = terms.tokenize_many(["Hello World", "Hello"])
+ *   ids = ids.unpack("L*")
+ *   offsets = offsets.unpack("L*")
+ *   offsets.each_cons(2).collect do |start, finish|
+ *     ids[start...finish]
+ *   end
+ *
+ * @overload tokenize_many(strings, options={})
+ *   @param strings [::Array<String>] The strings to be tokenized.
+ *   @param options [::Hash]
+ *   @option options [Bool] :add (true) Adds new tokens to the table if
+ *     true. Otherwise, new tokens are just ignored.
+ *   @option options [Symbol] :as (:ids) The format of the result.
+ *
+ *     * `:ids`: `[ids, offsets]`. `ids` is token IDs of all strings.
+ *       `offsets` has `strings.size + 1` elements. Token IDs of the
+ *       `i`-th string are `ids[offsets[i]...offsets[i + 1]]`.
+ *     * `:records`: `::Array<::Array<Groonga::Record>>` like
+ *       {#tokenize} for each string.
+ *   @return [::Array<String>, ::Array<::Array<Groonga::Record>>]
+ *     The tokenized tokens. See `:as` for details.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_table_key_support_tokenize_many (int argc, VALUE *argv, VALUE self)
+{
+    VALUE rb_strings, rb_options, rb_add_p, rb_as;
+    VALUE rb_result;
+    bool as_ids_p = true;
+    TokenizeManyData data;
+    grn_obj string_tokens;
+    grn_obj tokens;
+    long i;
+
+    rb_scan_args(argc, argv, "11", &rb_strings, &rb_options);
+    rb_grn_scan_options(rb_options,
+                        "add", &rb_add_p,
+                        "as", &rb_as,
+                        NULL);
+    if (NIL_P(rb_add_p)) {
+        rb_add_p = Qtrue;
+    }
+    if (NIL_P(rb_as) || rb_grn_equal_option(rb_as, "ids")) {
+        as_ids_p = true;
+    } else if (rb_grn_equal_option(rb_as, "records")) {
+        as_ids_p = false;
+    } else {
+        rb_raise(rb_eArgError,
+                 "format should be one of [:ids, :records]: %" PRIsVALUE,
+                 rb_as);
+    }
+
+    rb_grn_table_key_support_deconstruct(SELF(self), &(data.table),
+                                         &(data.context),
+                                         NULL, NULL, NULL,
+                                         NULL, NULL, NULL,
+                                         NULL);
+
+    rb_strings = rb_ary_dup(rb_grn_convert_to_array(rb_strings));
+    data.n_strings = RARRAY_LEN(rb_strings);
+    for (i = 0; i < data.n_strings; i++) {
+        VALUE rb_string = RARRAY_AREF(rb_strings, i);
+        StringValue(rb_string);
+        /* Strings must not be changed by other threads while the GVL
+         * is released. A frozen copy shares the original buffer. */
+        rb_ary_store(rb_strings, i, rb_str_new_frozen(rb_string));
+    }
+
+    data.add_p = RVAL2CBOOL(rb_add_p);
+    data.strings = ALLOC_N(const char *, data.n_strings);
+    data.string_sizes = ALLOC_N(unsigned int, data.n_strings);
+    data.offsets = ALLOC_N(uint32_t, data.n_strings + 1);
+    memset(data.offsets, 0, sizeof(uint32_t) * (data.n_strings + 1));
+    for (i = 0; i < data.n_strings; i++) {
+        VALUE rb_string = RARRAY_AREF(rb_strings, i);
+        data.strings[i] = RSTRING_PTR(rb_string);
+        data.string_sizes[i] = RSTRING_LEN(rb_string);
+    }
+    GRN_RECORD_INIT(&string_tokens, GRN_OBJ_VECTOR,
+                    grn_obj_id(data.context, data.table));
+    GRN_RECORD_INIT(&tokens, GRN_OBJ_VECTOR,
+                    grn_obj_id(data.context, data.table));
+    data.string_tokens = &string_tokens;
+    data.tokens = &tokens;
+
+    rb_grn_context_call_without_gvl(data.context,
+                                    rb_grn_table_key_support_tokenize_many_without_gvl,
+                                    &data);
+    RB_GC_GUARD(rb_strings);
+    xfree(data.strings);
+    xfree(data.string_sizes);
+    GRN_OBJ_FIN(data.context, &string_tokens);
+
+    if (data.context->rc != GRN_SUCCESS) {
+        xfree(data.offsets);
+        GRN_OBJ_FIN(data.context, &tokens);
+        rb_grn_context_check(data.context, self);
+    }
+
+    if (as_ids_p) {
+        VALUE rb_ids, rb_offsets;
+        rb_ids = rb_str_new(GRN_BULK_HEAD(&tokens), GRN_BULK_VSIZE(&tokens));
+        rb_offsets = rb_str_new((const char *)(data.offsets),
+                                sizeof(uint32_t) * (data.n_strings + 1));
+        rb_result = rb_ary_new_from_args(2, rb_ids, rb_offsets);
+    } else {
+        grn_id *ids = (grn_id *)GRN_BULK_HEAD(&tokens);
+        rb_result = rb_ary_new2(data.n_strings);
+        for (i = 0; i < data.n_strings; i++) {
+            VALUE rb_tokens;
+            uint32_t j;
+
+            rb_tokens = rb_ary_new2(data.offsets[i + 1] - data.offsets[i]);
+            for (j = data.offsets[i]; j < data.offsets[i + 1]; j++) {
+                rb_ary_push(rb_tokens,
+                            rb_grn_record_new(self, ids[j], Qnil));
+            }
+            rb_ary_push(rb_result, rb_tokens);
+        }
+    }
+    xfree(data.offsets);
+    GRN_OBJ_FIN(data.context, &tokens);
+
+    return rb_result;
+}
+
 /*
  * Recreates all index columns in the table.
  *
@@ -1196,6 +1377,8 @@ rb_grn_init_table_key_support (VALUE mGrn)
 
     rb_define_method(rb_mGrnTableKeySupport, "tokenize",
                      rb_grn_table_key_support_tokenize, -1);
+    rb_define_method(rb_mGrnTableKeySupport, "tokenize_many",
+                     rb_grn_table_key_support_tokenize_many, -1);
 
     rb_define_method(rb_mGrnTableKeySupport, "reindex",
                      rb_grn_table_key_support_reindex, 0);
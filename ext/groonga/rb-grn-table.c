@@ -1,6 +1,6 @@
 /* -*- coding: utf-8; mode: C; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 /*
-  Copyright (C) 2009-2022  Sutou Kouhei <kou@clear-code.com>
+  Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
   Copyright (C) 2014-2016  Masafumi Yokoyama <yokoyama@clear-code.com>
   Copyright (C) 2019  Horimoto Yasuhiro <horimoto@clear-code.com>
 
@@ -822,6 +822,74 @@ rb_grn_table_have_column (VALUE self, VALUE rb_name)
     }
 }
 
+/*
+ * Reads values of the specified columns for many records at
+ * once. It's a batch version of {Groonga::Record#[]}. See
+ * also {Groonga::DataColumn#values_at}.
+ *
+ * @example Read all names and ages in the table.
+ *
+ *   users = Groonga["Users"]
+ *   names, ages = users.column_arrays(["name", "age"])
+ *
+ * @example Read values of records in a search result.
+ *
+ *   adults = users.select {|record| record.age >= 20}
+ *   names, ages = adults.column_arrays(["name", "age"])
+ *
+ * @overload column_arrays(column_names, ids=nil)
+ *   @param column_names [::Array<String, Symbol>] The names of
+ *     the columns to be read. Accessors such as `"_key"` are
+ *     also available.
+ *   @param ids [::Array<Integer, Groonga::Record, Object>,
+ *     Groonga::Table, nil] The records to be read. If this is
+ *     `nil`, values of all records in the table are read.
+ *
+ *   @return [::Array<::Array<Object>>] The values of each column
+ *     in the order of `column_names`.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_table_get_column_arrays (int argc, VALUE *argv, VALUE self)
+{
+    grn_ctx *context = NULL;
+    grn_obj *table;
+    VALUE rb_column_names;
+    VALUE rb_ids;
+    VALUE rb_packed_ids;
+    VALUE rb_column_arrays;
+    long i, n;
+
+    rb_scan_args(argc, argv, "11", &rb_column_names, &rb_ids);
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL,
+                             NULL, NULL, NULL,
+                             NULL);
+
+    rb_column_names = rb_grn_convert_to_array(rb_column_names);
+    rb_packed_ids = rb_grn_column_collect_ids(context, table, rb_ids, self);
+    n = RARRAY_LEN(rb_column_names);
+    rb_column_arrays = rb_ary_new_capa(n);
+    for (i = 0; i < n; i++) {
+        VALUE rb_column;
+        grn_obj *column;
+
+        rb_column =
+            rb_grn_table_get_column_surely(self,
+                                           RARRAY_AREF(rb_column_names, i));
+        column = RVAL2GRNOBJECT(rb_column, &context);
+        rb_ary_push(rb_column_arrays,
+                    rb_grn_column_values_at(context,
+                                            column,
+                                            rb_packed_ids,
+                                            rb_column));
+    }
+
+    return rb_column_arrays;
+}
+
 static grn_table_cursor *
 rb_grn_table_open_grn_cursor (int argc, VALUE *argv, VALUE self,
                               grn_ctx **context)
@@ -1143,6 +1211,194 @@ rb_grn_table_each (int argc, VALUE *argv, VALUE self)
     return Qnil;
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_table_cursor *cursor;
+    VALUE self;
+    VALUE rb_cursor_options;
+    VALUE rb_columns;
+    grn_bool reuse;
+    long n_columns;
+    grn_obj **columns;
+    grn_obj **ranges;
+    grn_obj *values;
+} EachRowData;
+
+static VALUE
+rb_grn_table_each_row_body (VALUE user_data)
+{
+    EachRowData *data = (EachRowData *)user_data;
+    grn_ctx *context = data->context;
+    RbGrnObject *rb_grn_object;
+    VALUE rb_row = Qnil;
+    long i;
+
+    for (i = 0; i < data->n_columns; i++) {
+        grn_obj *column;
+
+        column = RVAL2GRNOBJECT(RARRAY_AREF(data->rb_columns, i), &context);
+        data->columns[i] = column;
+        data->ranges[i] = grn_ctx_at(context,
+                                     grn_obj_get_range(context, column));
+        grn_obj_reinit_for(context, &(data->values[i]), column);
+    }
+    data->cursor = rb_grn_table_open_grn_cursor(1,
+                                                &(data->rb_cursor_options),
+                                                data->self,
+                                                &context);
+    if (!data->cursor) {
+        return Qnil;
+    }
+
+    rb_grn_object = RB_GRN_OBJECT(SELF(data->self));
+    while (GRN_TRUE) {
+        grn_id id;
+
+        if (!rb_grn_object->object) {
+            break;
+        }
+
+        id = grn_table_cursor_next(context, data->cursor);
+        if (id == GRN_ID_NIL) {
+            break;
+        }
+
+        if (data->reuse && !NIL_P(rb_row)) {
+            rb_ary_clear(rb_row);
+        } else {
+            rb_row = rb_ary_new_capa(data->n_columns);
+        }
+        for (i = 0; i < data->n_columns; i++) {
+            grn_obj *value = &(data->values[i]);
+
+            GRN_BULK_REWIND(value);
+            grn_obj_get_value(context, data->columns[i], id, value);
+            rb_ary_push(rb_row,
+                        GRNVALUE2RVAL(context,
+                                      value,
+                                      data->ranges[i],
+                                      RARRAY_AREF(data->rb_columns, i)));
+        }
+        rb_yield(rb_row);
+    }
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_each_row_ensure (VALUE user_data)
+{
+    EachRowData *data = (EachRowData *)user_data;
+    long i;
+
+    if (data->cursor)
+        grn_table_cursor_close(data->context, data->cursor);
+    for (i = 0; i < data->n_columns; i++) {
+        GRN_OBJ_FIN(data->context, &(data->values[i]));
+    }
+    xfree(data->columns);
+    xfree(data->ranges);
+    xfree(data->values);
+
+    return Qnil;
+}
+
+/*
+ * Iterates records in the table and yields values of the specified
+ * columns as an Array.
+ *
+ * Columns are resolved only once before iteration and
+ * {Groonga::Record} isn't created for each record. It's faster
+ * than {#each} with `record[column_name]` for scanning many records.
+ *
+ * @example Scan names and ages of all users.
+ *
+ *   users.each_row(:columns => ["_key", "name", "age"]) do |key, name, age|
+ *     p [key, name, age]
+ *   end
+ *
+ * @example Reuse the yielded Array to reduce allocations.
+ *
+ *   users.each_row(:columns => ["age"], :reuse => true) do |row|
+ *     total += row[0]
+ *   end
+ *
+ * @overload each_row(options)
+ *   @param options [::Hash] The name and value pairs. Other
+ *     options are the same as {#open_cursor}'s one.
+ *   @option options :columns [::Array<String, Symbol>] The names of
+ *     the columns to be read. Accessors such as `"_key"` are also
+ *     available. This is required.
+ *   @option options :reuse [Boolean] (false) If it's `true`, the
+ *     same Array is yielded for all records. Its content is replaced
+ *     with values of the next record. Don't keep the yielded Array
+ *     after the block is finished.
+ *   @yield [row] Yields the values of each record.
+ *   @yieldparam row [::Array<Object>] The values in the order of
+ *     `:columns`.
+ *   @return [nil]
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_table_each_row (int argc, VALUE *argv, VALUE self)
+{
+    EachRowData data;
+    grn_obj *table;
+    VALUE rb_options, rb_cursor_options;
+    VALUE rb_column_names, rb_reuse;
+    long i;
+
+    RETURN_ENUMERATOR(self, argc, argv);
+
+    rb_scan_args(argc, argv, "1", &rb_options);
+
+    rb_cursor_options = rb_grn_check_convert_to_hash(rb_options);
+    if (NIL_P(rb_cursor_options)) {
+        rb_raise(rb_eArgError,
+                 "options must be Hash: %" PRIsVALUE,
+                 rb_options);
+    }
+    rb_cursor_options = rb_hash_dup(rb_cursor_options);
+    rb_column_names = rb_hash_delete(rb_cursor_options,
+                                     RB_GRN_INTERN("columns"));
+    rb_reuse = rb_hash_delete(rb_cursor_options, RB_GRN_INTERN("reuse"));
+    if (NIL_P(rb_column_names)) {
+        rb_raise(rb_eArgError, ":columns is missing: %" PRIsVALUE, rb_options);
+    }
+
+    data.context = NULL;
+    rb_grn_table_deconstruct(SELF(self), &table, &(data.context),
+                             NULL, NULL,
+                             NULL, NULL, NULL,
+                             NULL);
+
+    rb_column_names = rb_grn_convert_to_array(rb_column_names);
+    data.self = self;
+    data.rb_cursor_options = rb_cursor_options;
+    data.reuse = RVAL2CBOOL(rb_reuse);
+    data.n_columns = RARRAY_LEN(rb_column_names);
+    data.rb_columns = rb_ary_new_capa(data.n_columns);
+    for (i = 0; i < data.n_columns; i++) {
+        rb_ary_push(data.rb_columns,
+                    rb_grn_table_get_column_surely(self,
+                                                   RARRAY_AREF(rb_column_names,
+                                                               i)));
+    }
+
+    data.cursor = NULL;
+    data.columns = ALLOC_N(grn_obj *, data.n_columns);
+    data.ranges = ALLOC_N(grn_obj *, data.n_columns);
+    data.values = ALLOC_N(grn_obj, data.n_columns);
+    for (i = 0; i < data.n_columns; i++) {
+        GRN_VOID_INIT(&(data.values[i]));
+    }
+    rb_ensure(rb_grn_table_each_row_body, (VALUE)&data,
+              rb_grn_table_each_row_ensure, (VALUE)&data);
+
+    return Qnil;
+}
+
 VALUE
 rb_grn_table_delete_by_id (VALUE self, VALUE rb_id)
 {
@@ -1254,145 +1510,854 @@ rb_grn_table_delete (int argc, VALUE *argv, VALUE self)
     return Qnil;
 }
 
-/*
- * テーブルに登録されているレコードを _keys_ で指定されたルー
- * ルに従ってソートしたレコードの配列を返す。
- *
- * _order_ には +:asc+ ,  +:ascending+ , +:desc+ , +:descending+ の
- * いずれを指定する。
- *
- * - ハッシュの配列で指定する方法 :=
- * オーソドックスな指定方法。
- *
- * <pre>
- * !!!ruby
- * [
- *  {:key => "第1ソートキー", :order => order},
- *  {:key => "第2ソートキー", :order => order},
- *  # ...,
- * ]
- * </pre>
- * =:
- *
- * - 配列の配列で指定する方法 :=
- * 少し簡単化した指定方法。
- *
- * <pre>
- * !!!ruby
- * [
- *  ["第1ソートキー", order],
- *  ["第2ソートキー", order],
- *  # ...,
- * ]
- * </pre>
- * =:
- *
- * - ソートキーの配列で指定する方法 :=
- * _order_ は常に昇順（ +:ascending+ ）になるが、最も簡単
- * に指定できる。
- *
- * <pre>
- * !!!ruby
- * ["第1ソートキー", "第2ソートキー", "..."]
- * </pre>
- * =:
- *
- * @overload sort(keys, options={})
- *   @param options [::Hash] The name and value
- *     pairs. Omitted names are initialized as the default value.
- *   @option options :offset
- *     ソートされたレコードのうち、(0ベースで) _:offset_ 番目
- *     からレコードを取り出す。
- *   @option options :limit
- *     ソートされたレコードのうち、 _:limit_ 件のみを取り出す。
- *     省略された場合または-1が指定された場合は、全件が指定され
- *     たものとみなす。
- *
- * @return [Groonga::Array] The sorted result. You can get the
- *   original record by {#value} method of a record in the sorted
- *   result. Normally, you doesn't need to get the original record
- *   because you can access via column name method:
- *
- *   <pre>
- *   !!!ruby
- *   names_recommended_access = sorted_users.collect do |sorted_user|
- *     sorted_user.name
- *   end
- *   names_manually_access = sorted_users.collect do |sorted_user|
- *     sorted_user.value.name
- *   end
- *   names_recommended_access == names_manually_access # => true
- *   </pre>
- *
- *   If you want to access the key of the original record, you need to
- *   get the original record.
- *
- * @note The return value is changed to {Groonga::Array} from
- *   {::Array} since 2.1.0. If you want to get before 2.1.0 style
- *   result, use the following code:
- *
- * @example Describe incompatible API change
- *   result_since_2_1_0 = table.sort(["sort_key"])
- *   result_before_2_1_0 = result_since_2_1_0.collect do |record|
- *     record.value
- *   end
- */
-static VALUE
-rb_grn_table_sort (int argc, VALUE *argv, VALUE self)
-{
-    grn_ctx *context = NULL;
+typedef struct {
+    grn_ctx *context;
     grn_obj *table;
+    int offset;
+    int limit;
     grn_obj *result;
     grn_table_sort_key *keys;
     int n_keys;
-    int offset = 0, limit = -1;
-    VALUE rb_keys, options;
-    VALUE rb_offset, rb_limit;
-    VALUE exception;
+} SortData;
 
-    rb_grn_table_deconstruct(SELF(self), &table, &context,
-                             NULL, NULL,
-                             NULL, NULL, NULL,
-                             NULL);
+static void *
+rb_grn_table_sort_without_gvl (void *user_data)
+{
+    SortData *data = user_data;
 
-    rb_scan_args(argc, argv, "11", &rb_keys, &options);
+    grn_table_sort(data->context, data->table,
+                   data->offset, data->limit,
+                   data->result,
+                   data->keys, data->n_keys);
 
-    if (!RVAL2CBOOL(rb_obj_is_kind_of(rb_keys, rb_cArray)))
-        rb_raise(rb_eArgError, "keys should be an array of key: <%s>",
-                 rb_grn_inspect(rb_keys));
+    return NULL;
+}
 
-    n_keys = RARRAY_LEN(rb_keys);
-    keys = ALLOCA_N(grn_table_sort_key, n_keys);
-    rb_grn_table_sort_keys_fill(context, keys, n_keys, rb_keys, self);
+typedef struct {
+    grn_ctx *context;
+    grn_id domain_id;
+    grn_bool with_score;
+    const grn_id *ids;
+    const double *scores;
+    long n_ids;
+    grn_obj *key_names;
+    const grn_table_sort_key *base_keys;
+    int n_keys;
+    int limit;
+    grn_id *top_ids;
+    double *top_scores;
+    long n_top_ids;
+    grn_rc rc;
+    char message[GRN_CTX_MSGSIZE];
+} SortPartition;
+
+static grn_obj *
+rb_grn_table_sort_parallel_create_records (grn_ctx *context,
+                                           grn_obj *domain,
+                                           grn_bool with_score,
+                                           const grn_id *ids,
+                                           const double *scores,
+                                           long n_ids)
+{
+    grn_obj *records;
+    grn_obj *score_accessor = NULL;
+    grn_obj score;
+    long i;
+
+    records = grn_table_create(context, NULL, 0, NULL,
+                               GRN_TABLE_HASH_KEY | GRN_OBJ_WITH_SUBREC,
+                               domain, NULL);
+    if (!records) {
+        return NULL;
+    }
 
-    rb_grn_scan_options(options,
-                        "offset", &rb_offset,
-                        "limit", &rb_limit,
-                        NULL);
+    if (with_score) {
+        score_accessor = grn_obj_column(context, records,
+                                        GRN_COLUMN_NAME_SCORE,
+                                        GRN_COLUMN_NAME_SCORE_LEN);
+        GRN_FLOAT_INIT(&score, 0);
+    }
+    for (i = 0; i < n_ids; i++) {
+        grn_id id;
+        id = grn_table_add(context, records, &(ids[i]), sizeof(grn_id), NULL);
+        if (score_accessor && id != GRN_ID_NIL) {
+            GRN_FLOAT_SET(context, &score, scores[i]);
+            grn_obj_set_value(context, score_accessor, id, &score, GRN_OBJ_SET);
+        }
+    }
+    if (score_accessor) {
+        GRN_OBJ_FIN(context, &score);
+        grn_obj_unlink(context, score_accessor);
+    }
 
-    if (!NIL_P(rb_offset))
-        offset = NUM2INT(rb_offset);
-    if (!NIL_P(rb_limit))
-        limit = NUM2INT(rb_limit);
+    return records;
+}
 
-    result = grn_table_create(context, NULL, 0, NULL, GRN_TABLE_NO_KEY,
-                              NULL, table);
-    /* use n_records that is return value from
-       grn_table_sort() when Rroonga user become specifying
-       output table. */
-    grn_table_sort(context, table, offset, limit, result, keys, n_keys);
-    exception = rb_grn_context_to_exception(context, self);
-    if (!NIL_P(exception)) {
-        grn_obj_unlink(context, result);
-        rb_exc_raise(exception);
+static grn_bool
+rb_grn_table_sort_parallel_open_keys (grn_ctx *context,
+                                      grn_obj *records,
+                                      grn_obj *key_names,
+                                      const grn_table_sort_key *base_keys,
+                                      grn_table_sort_key *keys,
+                                      int n_keys)
+{
+    int i;
+
+    for (i = 0; i < n_keys; i++) {
+        const char *name;
+        unsigned int name_size;
+
+        name_size = grn_vector_get_element(context, key_names, i,
+                                           &name, NULL, NULL);
+        keys[i].key = grn_obj_column(context, records, name, name_size);
+        keys[i].flags = base_keys[i].flags;
+        keys[i].offset = 0;
+        if (!keys[i].key) {
+            if (context->rc == GRN_SUCCESS) {
+                context->rc = GRN_INVALID_ARGUMENT;
+                snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                         "[table][sort][parallel] no such column: <%.*s>",
+                         (int)name_size, name);
+            }
+            for (i--; i >= 0; i--) {
+                grn_obj_unlink(context, keys[i].key);
+            }
+            return GRN_FALSE;
+        }
     }
 
-    return GRNOBJECT2RVAL(Qnil, context, result, GRN_TRUE);
+    return GRN_TRUE;
+}
+
+static void
+rb_grn_table_sort_parallel_close_keys (grn_ctx *context,
+                                       grn_table_sort_key *keys,
+                                       int n_keys)
+{
+    int i;
+
+    for (i = 0; i < n_keys; i++) {
+        grn_obj_unlink(context, keys[i].key);
+    }
 }
 
 /*
- * Sorts records in the table by `TokyoGeoPoint` or `WGS84GeoPoint`
- * type column value. Order is near to far from base geo point.
+ * Sorts `records` and returns a NO_KEY table of the sorted
+ * `records`. `keys` must be opened for `records`.
+ */
+static grn_obj *
+rb_grn_table_sort_parallel_sort (grn_ctx *context,
+                                 grn_obj *records,
+                                 int offset,
+                                 int limit,
+                                 grn_table_sort_key *keys,
+                                 int n_keys)
+{
+    grn_obj *sorted;
+
+    sorted = grn_table_create(context, NULL, 0, NULL, GRN_TABLE_NO_KEY,
+                              NULL, records);
+    if (!sorted) {
+        return NULL;
+    }
+    grn_table_sort(context, records, offset, limit, sorted, keys, n_keys);
+    return sorted;
+}
+
+static void *
+rb_grn_table_sort_partition (void *user_data)
+{
+    SortPartition *partition = user_data;
+    grn_ctx *context = partition->context;
+    grn_obj *domain;
+    grn_obj *records = NULL;
+    grn_obj *sorted = NULL;
+    grn_obj *score_accessor = NULL;
+    grn_table_sort_key *keys;
+    grn_table_cursor *cursor;
+    grn_obj score;
+    grn_id sorted_id;
+
+    keys = calloc(partition->n_keys, sizeof(grn_table_sort_key));
+    if (!keys) {
+        context->rc = GRN_NO_MEMORY_AVAILABLE;
+        snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                 "[table][sort][parallel] failed to allocate sort keys");
+        goto exit;
+    }
+
+    domain = grn_ctx_at(context, partition->domain_id);
+    if (!domain) {
+        goto exit;
+    }
+    records = rb_grn_table_sort_parallel_create_records(context,
+                                                        domain,
+                                                        partition->with_score,
+                                                        partition->ids,
+                                                        partition->scores,
+                                                        partition->n_ids);
+    if (!records) {
+        goto exit;
+    }
+    if (!rb_grn_table_sort_parallel_open_keys(context,
+                                              records,
+                                              partition->key_names,
+                                              partition->base_keys,
+                                              keys,
+                                              partition->n_keys)) {
+        goto exit;
+    }
+    /* Only the first "offset + limit" records of each partition can
+     * be in the final result. */
+    sorted = rb_grn_table_sort_parallel_sort(context,
+                                             records,
+                                             0,
+                                             partition->limit,
+                                             keys,
+                                             partition->n_keys);
+    rb_grn_table_sort_parallel_close_keys(context, keys, partition->n_keys);
+    if (!sorted) {
+        goto exit;
+    }
+
+    partition->top_ids = malloc(sizeof(grn_id) *
+                                (grn_table_size(context, sorted) + 1));
+    partition->top_scores = malloc(sizeof(double) *
+                                   (grn_table_size(context, sorted) + 1));
+    if (!partition->top_ids || !partition->top_scores) {
+        context->rc = GRN_NO_MEMORY_AVAILABLE;
+        snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                 "[table][sort][parallel] failed to allocate sorted IDs");
+        goto exit;
+    }
+    if (partition->with_score) {
+        score_accessor = grn_obj_column(context, records,
+                                        GRN_COLUMN_NAME_SCORE,
+                                        GRN_COLUMN_NAME_SCORE_LEN);
+    }
+    GRN_FLOAT_INIT(&score, 0);
+    cursor = grn_table_cursor_open(context, sorted,
+                                   NULL, 0, NULL, 0,
+                                   0, -1, GRN_CURSOR_ASCENDING);
+    while (cursor &&
+           (sorted_id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+        void *value;
+        grn_id record_id;
+        grn_id id;
+
+        grn_table_cursor_get_value(context, cursor, &value);
+        record_id = *((grn_id *)value);
+        grn_table_get_key(context, records, record_id, &id, sizeof(grn_id));
+        partition->top_ids[partition->n_top_ids] = id;
+        if (score_accessor) {
+            GRN_BULK_REWIND(&score);
+            grn_obj_get_value(context, score_accessor, record_id, &score);
+            partition->top_scores[partition->n_top_ids] = GRN_FLOAT_VALUE(&score);
+        } else {
+            partition->top_scores[partition->n_top_ids] = 0.0;
+        }
+        partition->n_top_ids++;
+    }
+    if (cursor) {
+        grn_table_cursor_close(context, cursor);
+    }
+    GRN_OBJ_FIN(context, &score);
+
+exit:
+    if (score_accessor) {
+        grn_obj_unlink(context, score_accessor);
+    }
+    if (sorted) {
+        grn_obj_close(context, sorted);
+    }
+    if (records) {
+        grn_obj_close(context, records);
+    }
+    free(keys);
+
+    partition->rc = context->rc;
+    if (partition->rc != GRN_SUCCESS) {
+        snprintf(partition->message, GRN_CTX_MSGSIZE, "%s", context->errbuf);
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    VALUE self;
+    grn_ctx *context;
+    grn_obj *table;
+    grn_obj *domain;
+    grn_bool with_score;
+    grn_table_sort_key *keys;
+    int n_keys;
+    int offset;
+    int limit;
+    grn_obj key_names;
+    VALUE rb_packed_ids;
+    VALUE rb_packed_scores;
+    RbGrnWorkerPool pool;
+    SortPartition *partitions;
+    long n_partitions;
+    grn_obj *result;
+} SortParallelData;
+
+#define RB_GRN_TABLE_SORT_PARALLEL_NAME_EQUAL(name, name_size, column_name) \
+    ((name_size) == column_name ## _LEN &&                             \
+     memcmp((name), column_name, (name_size)) == 0)
+
+/*
+ * Returns whether workers can sort by the key. Workers only know
+ * columns of the persistent domain and `_score` of a select
+ * result. They don't know temporary columns and pseudo columns such
+ * as `_nsubrecs` of a result.
+ */
+static grn_bool
+rb_grn_table_sort_parallel_is_available_key (SortParallelData *data,
+                                             grn_obj *key,
+                                             const char *name,
+                                             int name_size)
+{
+    grn_ctx *context = data->context;
+    grn_obj *column;
+    grn_bool available;
+
+    if (!key) {
+        return GRN_FALSE;
+    }
+    if (RB_GRN_TABLE_SORT_PARALLEL_NAME_EQUAL(name, name_size,
+                                              GRN_COLUMN_NAME_KEY)) {
+        return GRN_TRUE;
+    }
+    if (RB_GRN_TABLE_SORT_PARALLEL_NAME_EQUAL(name, name_size,
+                                              GRN_COLUMN_NAME_ID)) {
+        /* IDs in partitions of a result aren't the same as IDs in
+         * the result. */
+        return !data->with_score;
+    }
+    if (RB_GRN_TABLE_SORT_PARALLEL_NAME_EQUAL(name, name_size,
+                                              GRN_COLUMN_NAME_SCORE)) {
+        return data->with_score;
+    }
+    if (grn_obj_is_column(context, key)) {
+        return key->header.domain == grn_obj_id(context, data->domain);
+    }
+    if (key->header.type != GRN_ACCESSOR) {
+        return GRN_FALSE;
+    }
+
+    column = grn_obj_column(context, data->domain, name, name_size);
+    if (!column) {
+        return GRN_FALSE;
+    }
+    available = grn_obj_is_column(context, column);
+    grn_obj_unlink(context, column);
+    return available;
+}
+
+static grn_bool
+rb_grn_table_sort_parallel_collect_key_names (SortParallelData *data)
+{
+    grn_ctx *context = data->context;
+    int i;
+
+    for (i = 0; i < data->n_keys; i++) {
+        char name[GRN_TABLE_MAX_KEY_SIZE];
+        int name_size;
+        grn_obj full_name;
+
+        name_size = grn_column_name(context, data->keys[i].key,
+                                    name, GRN_TABLE_MAX_KEY_SIZE);
+        if (!rb_grn_table_sort_parallel_is_available_key(data,
+                                                         data->keys[i].key,
+                                                         name,
+                                                         name_size)) {
+            return GRN_FALSE;
+        }
+        GRN_TEXT_INIT(&full_name, 0);
+        if (!data->with_score) {
+            /* Records of each partition refer to the target table by
+             * their keys. */
+            GRN_TEXT_PUTS(context, &full_name, GRN_COLUMN_NAME_KEY ".");
+        }
+        GRN_TEXT_PUT(context, &full_name, name, name_size);
+        grn_vector_add_element(context, &(data->key_names),
+                               GRN_TEXT_VALUE(&full_name),
+                               GRN_TEXT_LEN(&full_name),
+                               0,
+                               GRN_DB_TEXT);
+        GRN_OBJ_FIN(context, &full_name);
+    }
+
+    return GRN_TRUE;
+}
+
+static void
+rb_grn_table_sort_parallel_collect_records (SortParallelData *data)
+{
+    grn_ctx *context = data->context;
+    grn_table_cursor *cursor;
+    grn_obj *score_accessor = NULL;
+    grn_obj score;
+    grn_id id;
+
+    data->rb_packed_ids =
+        rb_str_buf_new(sizeof(grn_id) * grn_table_size(context, data->table));
+    data->rb_packed_scores = rb_str_buf_new(0);
+    if (data->with_score) {
+        score_accessor = grn_obj_column(context, data->table,
+                                        GRN_COLUMN_NAME_SCORE,
+                                        GRN_COLUMN_NAME_SCORE_LEN);
+    }
+    GRN_FLOAT_INIT(&score, 0);
+    cursor = grn_table_cursor_open(context, data->table,
+                                   NULL, 0, NULL, 0,
+                                   0, -1, GRN_CURSOR_ASCENDING);
+    rb_grn_context_check(context, data->self);
+    while ((id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+        grn_id record_id = id;
+        if (data->with_score) {
+            double score_value;
+            grn_table_get_key(context, data->table, id,
+                              &record_id, sizeof(grn_id));
+            GRN_BULK_REWIND(&score);
+            grn_obj_get_value(context, score_accessor, id, &score);
+            score_value = GRN_FLOAT_VALUE(&score);
+            rb_str_cat(data->rb_packed_scores,
+                       (const char *)&score_value, sizeof(double));
+        }
+        rb_str_cat(data->rb_packed_ids,
+                   (const char *)&record_id, sizeof(grn_id));
+    }
+    grn_table_cursor_close(context, cursor);
+    GRN_OBJ_FIN(context, &score);
+    if (score_accessor) {
+        grn_obj_unlink(context, score_accessor);
+    }
+}
+
+static void
+rb_grn_table_sort_parallel_merge (SortParallelData *data)
+{
+    grn_ctx *context = data->context;
+    grn_obj *records;
+    grn_obj *sorted = NULL;
+    grn_table_sort_key *keys;
+    grn_table_cursor *cursor;
+    grn_obj record;
+    grn_id sorted_id;
+    VALUE rb_merged_ids;
+    VALUE rb_merged_scores;
+    long i;
+
+    rb_merged_ids = rb_str_buf_new(0);
+    rb_merged_scores = rb_str_buf_new(0);
+    for (i = 0; i < data->n_partitions; i++) {
+        SortPartition *partition = &(data->partitions[i]);
+        rb_str_cat(rb_merged_ids,
+                   (const char *)(partition->top_ids),
+                   sizeof(grn_id) * partition->n_top_ids);
+        rb_str_cat(rb_merged_scores,
+                   (const char *)(partition->top_scores),
+                   sizeof(double) * partition->n_top_ids);
+    }
+
+    records = rb_grn_table_sort_parallel_create_records(
+        context,
+        data->domain,
+        data->with_score,
+        (const grn_id *)RSTRING_PTR(rb_merged_ids),
+        (const double *)RSTRING_PTR(rb_merged_scores),
+        RSTRING_LEN(rb_merged_ids) / sizeof(grn_id));
+    rb_grn_context_check(context, data->self);
+
+    keys = ALLOCA_N(grn_table_sort_key, data->n_keys);
+    if (rb_grn_table_sort_parallel_open_keys(context,
+                                             records,
+                                             &(data->key_names),
+                                             data->keys,
+                                             keys,
+                                             data->n_keys)) {
+        sorted = rb_grn_table_sort_parallel_sort(context,
+                                                 records,
+                                                 data->offset,
+                                                 data->limit,
+                                                 keys,
+                                                 data->n_keys);
+        rb_grn_table_sort_parallel_close_keys(context, keys, data->n_keys);
+    }
+    if (!sorted) {
+        grn_obj_close(context, records);
+        rb_grn_context_check(context, data->self);
+        return;
+    }
+
+    /* The result must refer to the target table like grn_table_sort()
+     * result. */
+    data->result = grn_table_create(context, NULL, 0, NULL, GRN_TABLE_NO_KEY,
+                                    NULL, data->table);
+    GRN_RECORD_INIT(&record, 0, grn_obj_id(context, data->table));
+    cursor = grn_table_cursor_open(context, sorted,
+                                   NULL, 0, NULL, 0,
+                                   0, -1, GRN_CURSOR_ASCENDING);
+    while (data->result && cursor &&
+           (sorted_id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+        void *value;
+        grn_id record_id;
+        grn_id id;
+        grn_id result_id;
+
+        grn_table_cursor_get_value(context, cursor, &value);
+        record_id = *((grn_id *)value);
+        grn_table_get_key(context, records, record_id, &id, sizeof(grn_id));
+        if (data->with_score) {
+            id = grn_table_get(context, data->table, &id, sizeof(grn_id));
+        }
+        result_id = grn_table_add(context, data->result, NULL, 0, NULL);
+        GRN_RECORD_SET(context, &record, id);
+        grn_obj_set_value(context, data->result, result_id, &record,
+                          GRN_OBJ_SET);
+    }
+    if (cursor) {
+        grn_table_cursor_close(context, cursor);
+    }
+    GRN_OBJ_FIN(context, &record);
+    grn_obj_close(context, sorted);
+    grn_obj_close(context, records);
+}
+
+static VALUE
+rb_grn_table_sort_parallel_body (VALUE user_data)
+{
+    SortParallelData *data = (SortParallelData *)user_data;
+    const grn_id *ids;
+    const double *scores;
+    long i, n_ids, offset;
+
+    rb_grn_table_sort_parallel_collect_records(data);
+
+    ids = (const grn_id *)RSTRING_PTR(data->rb_packed_ids);
+    scores = (const double *)RSTRING_PTR(data->rb_packed_scores);
+    n_ids = RSTRING_LEN(data->rb_packed_ids) / sizeof(grn_id);
+    offset = 0;
+    /* Workers must not outlive this function because they refer
+     * data->rb_packed_ids and data->key_names. */
+    for (i = 0; i < data->n_partitions; i++) {
+        SortPartition *partition = &(data->partitions[i]);
+        long n_partition_ids;
+
+        n_partition_ids = n_ids / data->n_partitions;
+        if (i < n_ids % data->n_partitions) {
+            n_partition_ids++;
+        }
+        partition->domain_id = grn_obj_id(data->context, data->domain);
+        partition->with_score = data->with_score;
+        partition->ids = ids + offset;
+        partition->scores = data->with_score ? scores + offset : NULL;
+        partition->n_ids = n_partition_ids;
+        partition->key_names = &(data->key_names);
+        partition->base_keys = data->keys;
+        partition->n_keys = data->n_keys;
+        partition->limit = data->offset + data->limit;
+        partition->rc = GRN_SUCCESS;
+        offset += n_partition_ids;
+
+        partition->context = rb_grn_worker_pool_get_context(&(data->pool), i);
+        rb_grn_worker_pool_spawn(&(data->pool), i,
+                                 rb_grn_table_sort_partition,
+                                 partition);
+    }
+    rb_grn_worker_pool_join(&(data->pool));
+
+    for (i = 0; i < data->n_partitions; i++) {
+        SortPartition *partition = &(data->partitions[i]);
+        if (partition->rc != GRN_SUCCESS) {
+            rb_raise(rb_grn_rc_to_exception(partition->rc),
+                     "failed to sort records in parallel: %s: %" PRIsVALUE,
+                     partition->message,
+                     data->self);
+        }
+    }
+
+    rb_grn_table_sort_parallel_merge(data);
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_sort_parallel_ensure (VALUE user_data)
+{
+    SortParallelData *data = (SortParallelData *)user_data;
+    long i;
+
+    rb_grn_worker_pool_fin(&(data->pool));
+    for (i = 0; i < data->n_partitions; i++) {
+        SortPartition *partition = &(data->partitions[i]);
+        free(partition->top_ids);
+        free(partition->top_scores);
+    }
+    xfree(data->partitions);
+    GRN_OBJ_FIN(data->context, &(data->key_names));
+
+    return Qnil;
+}
+
+/*
+ * Sorts records by `n_workers` workers. It returns `NULL` when
+ * parallel sort can't be used for the table. Records are split into
+ * `n_workers` partitions. Each worker sorts its partition with its
+ * own context without the GVL and keeps only the first `offset +
+ * limit` records. The kept records are sorted again to get the
+ * final result.
+ *
+ * The table must be a persistent table or a temporary table that
+ * refers a persistent table by its key such as a result of
+ * {Groonga::Table#select}. Workers can't refer other temporary
+ * tables. It also returns `NULL` when a sort key is a temporary
+ * column or a pseudo column that workers don't know such as
+ * `_nsubrecs`.
+ */
+static grn_obj *
+rb_grn_table_sort_parallel (VALUE self,
+                            grn_ctx *context,
+                            grn_obj *table,
+                            grn_table_sort_key *keys,
+                            int n_keys,
+                            int offset,
+                            int limit,
+                            long n_workers)
+{
+    SortParallelData data;
+
+    data.domain = NULL;
+    data.with_score = GRN_FALSE;
+    if (table->header.flags & GRN_OBJ_PERSISTENT) {
+        data.domain = table;
+    } else if (table->header.flags & GRN_OBJ_WITH_SUBREC) {
+        grn_obj *domain = grn_ctx_at(context, table->header.domain);
+        if (domain &&
+            grn_obj_is_table(context, domain) &&
+            (domain->header.flags & GRN_OBJ_PERSISTENT)) {
+            data.domain = domain;
+            data.with_score = GRN_TRUE;
+        }
+    }
+    if (!data.domain) {
+        return NULL;
+    }
+
+    data.self = self;
+    data.context = context;
+    data.table = table;
+    data.keys = keys;
+    data.n_keys = n_keys;
+    data.offset = offset;
+    data.limit = limit;
+    data.rb_packed_ids = Qnil;
+    data.rb_packed_scores = Qnil;
+    data.n_partitions = n_workers;
+    data.result = NULL;
+    GRN_TEXT_INIT(&(data.key_names), GRN_OBJ_VECTOR);
+    if (!rb_grn_table_sort_parallel_collect_key_names(&data)) {
+        GRN_OBJ_FIN(context, &(data.key_names));
+        return NULL;
+    }
+    data.partitions = ZALLOC_N(SortPartition, data.n_partitions);
+    rb_grn_worker_pool_init(&(data.pool), context, data.n_partitions);
+    rb_ensure(rb_grn_table_sort_parallel_body, (VALUE)&data,
+              rb_grn_table_sort_parallel_ensure, (VALUE)&data);
+    RB_GC_GUARD(data.rb_packed_ids);
+    RB_GC_GUARD(data.rb_packed_scores);
+
+    return data.result;
+}
+
+/*
+ * テーブルに登録されているレコードを _keys_ で指定されたルー
+ * ルに従ってソートしたレコードの配列を返す。
+ *
+ * _order_ には +:asc+ ,  +:ascending+ , +:desc+ , +:descending+ の
+ * いずれを指定する。
+ *
+ * - ハッシュの配列で指定する方法 :=
+ * オーソドックスな指定方法。
+ *
+ * <pre>
+ * !!!ruby
+ * [
+ *  {:key => "第1ソートキー", :order => order},
+ *  {:key => "第2ソートキー", :order => order},
+ *  # ...,
+ * ]
+ * </pre>
+ * =:
+ *
+ * - 配列の配列で指定する方法 :=
+ * 少し簡単化した指定方法。
+ *
+ * <pre>
+ * !!!ruby
+ * [
+ *  ["第1ソートキー", order],
+ *  ["第2ソートキー", order],
+ *  # ...,
+ * ]
+ * </pre>
+ * =:
+ *
+ * - ソートキーの配列で指定する方法 :=
+ * _order_ は常に昇順（ +:ascending+ ）になるが、最も簡単
+ * に指定できる。
+ *
+ * <pre>
+ * !!!ruby
+ * ["第1ソートキー", "第2ソートキー", "..."]
+ * </pre>
+ * =:
+ *
+ * @overload sort(keys, options={})
+ *   @param options [::Hash] The name and value
+ *     pairs. Omitted names are initialized as the default value.
+ *   @option options :offset
+ *     ソートされたレコードのうち、(0ベースで) _:offset_ 番目
+ *     からレコードを取り出す。
+ *   @option options :limit
+ *     ソートされたレコードのうち、 _:limit_ 件のみを取り出す。
+ *     省略された場合または-1が指定された場合は、全件が指定され
+ *     たものとみなす。
+ *   @option options :n_workers [Integer] (1)
+ *     The number of workers. If this is 2 or larger and `:limit`
+ *     is specified, records are split into `:n_workers`
+ *     partitions and each partition is sorted in parallel by its
+ *     own context without the GVL. Each worker keeps only the
+ *     first `:offset + :limit` records of its partition and they
+ *     are sorted again to get the final result. It's fast for a
+ *     large table with a small `:limit`.
+ *
+ *     The table must be a persistent table or a result of
+ *     {#select} for a persistent table. Sort keys must be columns
+ *     of the target table such as `"_score"`, `"_key"` and
+ *     `"name"`. Temporary columns and pseudo columns of a result
+ *     of {#group} such as `"_nsubrecs"` can't be used. The
+ *     records are sorted by one worker when these conditions
+ *     aren't satisfied.
+ *
+ *     @since 15.0.5
+ *
+ * @return [Groonga::Array] The sorted result. You can get the
+ *   original record by {#value} method of a record in the sorted
+ *   result. Normally, you doesn't need to get the original record
+ *   because you can access via column name method:
+ *
+ *   <pre>
+ *   !!!ruby
+ *   names_recommended_access = sorted_users.collect do |sorted_user|
+ *     sorted_user.name
+ *   end
+ *   names_manually_access = sorted_users.collect do |sorted_user|
+ *     sorted_user.value.name
+ *   end
+ *   names_recommended_access == names_manually_access # => true
+ *   </pre>
+ *
+ *   If you want to access the key of the original record, you need to
+ *   get the original record.
+ *
+ * @note The return value is changed to {Groonga::Array} from
+ *   {::Array} since 2.1.0. If you want to get before 2.1.0 style
+ *   result, use the following code:
+ *
+ * @example Describe incompatible API change
+ *   result_since_2_1_0 = table.sort(["sort_key"])
+ *   result_before_2_1_0 = result_since_2_1_0.collect do |record|
+ *     record.value
+ *   end
+ */
+static VALUE
+rb_grn_table_sort (int argc, VALUE *argv, VALUE self)
+{
+    grn_ctx *context = NULL;
+    grn_obj *table;
+    grn_obj *result;
+    grn_table_sort_key *keys;
+    int n_keys;
+    int offset = 0, limit = -1;
+    VALUE rb_keys, options;
+    VALUE rb_offset, rb_limit, rb_n_workers;
+    VALUE exception;
+    SortData data;
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL,
+                             NULL, NULL, NULL,
+                             NULL);
+
+    rb_scan_args(argc, argv, "11", &rb_keys, &options);
+
+    if (!RVAL2CBOOL(rb_obj_is_kind_of(rb_keys, rb_cArray)))
+        rb_raise(rb_eArgError, "keys should be an array of key: <%s>",
+                 rb_grn_inspect(rb_keys));
+
+    n_keys = RARRAY_LEN(rb_keys);
+    keys = ALLOCA_N(grn_table_sort_key, n_keys);
+    rb_grn_table_sort_keys_fill(context, keys, n_keys, rb_keys, self);
+
+    rb_grn_scan_options(options,
+                        "offset", &rb_offset,
+                        "limit", &rb_limit,
+                        "n_workers", &rb_n_workers,
+                        NULL);
+
+    if (!NIL_P(rb_offset))
+        offset = NUM2INT(rb_offset);
+    if (!NIL_P(rb_limit))
+        limit = NUM2INT(rb_limit);
+
+    if (!NIL_P(rb_n_workers)) {
+        long n_workers = NUM2LONG(rb_n_workers);
+        if (n_workers < 1) {
+            rb_raise(rb_eArgError,
+                     ":n_workers must be 1 or larger: %" PRIsVALUE,
+                     rb_n_workers);
+        }
+        if (n_workers > 1 && limit >= 0 && offset >= 0) {
+            result = rb_grn_table_sort_parallel(self, context, table,
+                                                keys, n_keys,
+                                                offset, limit,
+                                                n_workers);
+            if (result) {
+                return GRNOBJECT2RVAL(Qnil, context, result, GRN_TRUE);
+            }
+        }
+    }
+
+    result = grn_table_create(context, NULL, 0, NULL, GRN_TABLE_NO_KEY,
+                              NULL, table);
+    /* use n_records that is return value from
+       grn_table_sort() when Rroonga user become specifying
+       output table. */
+    data.context = context;
+    data.table = table;
+    data.offset = offset;
+    data.limit = limit;
+    data.result = result;
+    data.keys = keys;
+    data.n_keys = n_keys;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_table_sort_without_gvl,
+                                    &data);
+    exception = rb_grn_context_to_exception(context, self);
+    if (!NIL_P(exception)) {
+        grn_obj_unlink(context, result);
+        rb_exc_raise(exception);
+    }
+
+    return GRNOBJECT2RVAL(Qnil, context, result, GRN_TRUE);
+}
+
+/*
+ * Sorts records in the table by `TokyoGeoPoint` or `WGS84GeoPoint`
+ * type column value. Order is near to far from base geo point.
  *
  * @overload geo_sort(column, base_geo_point, options={})
  *   @param options [::Hash] The name and value
@@ -1499,6 +2464,27 @@ rb_grn_table_geo_sort (int argc, VALUE *argv, VALUE self)
     return GRNOBJECT2RVAL(Qnil, context, result, GRN_TRUE);
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    grn_table_sort_key *keys;
+    int n_keys;
+    grn_table_group_result *result;
+    grn_rc rc;
+} GroupData;
+
+static void *
+rb_grn_table_group_without_gvl (void *user_data)
+{
+    GroupData *data = user_data;
+
+    data->rc = grn_table_group(data->context, data->table,
+                               data->keys, data->n_keys,
+                               data->result, 1);
+
+    return NULL;
+}
+
 /*
  * _table_ のレコードを _key1_ , _key2_ , _..._ で指定したキーの
  * 値でグループ化する。多くの場合、キーにはカラムを指定する。
@@ -1567,6 +2553,7 @@ rb_grn_table_group (int argc, VALUE *argv, VALUE self)
     VALUE rb_keys, rb_options, rb_max_n_sub_records;
     VALUE rb_calc_target, rb_calc_types;
     VALUE *rb_group_keys;
+    GroupData data;
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
                              NULL, NULL,
@@ -1596,87 +2583,861 @@ rb_grn_table_group (int argc, VALUE *argv, VALUE self)
             max_n_sub_records = 0;
         }
     } else {
-        max_n_sub_records = NUM2UINT(rb_max_n_sub_records);
+        max_n_sub_records = NUM2UINT(rb_max_n_sub_records);
+    }
+
+    keys = ALLOCA_N(grn_table_sort_key, n_keys);
+    for (i = 0; i < n_keys; i++) {
+        VALUE rb_sort_options, rb_key;
+
+        if (RVAL2CBOOL(rb_obj_is_kind_of(rb_group_keys[i], rb_cHash))) {
+            rb_sort_options = rb_group_keys[i];
+        } else {
+            rb_sort_options = rb_hash_new();
+            rb_hash_aset(rb_sort_options,
+                         RB_GRN_INTERN("key"),
+                         rb_group_keys[i]);
+        }
+        rb_grn_scan_options(rb_sort_options,
+                            "key", &rb_key,
+                            NULL);
+        if (RVAL2CBOOL(rb_obj_is_kind_of(rb_key, rb_cString))) {
+            VALUE resolved_rb_key;
+            resolved_rb_key = rb_grn_table_get_column(self, rb_key);
+            if (NIL_P(resolved_rb_key)) {
+                rb_raise(rb_eArgError,
+                         "unknown group key: <%s>: <%s>",
+                         rb_grn_inspect(rb_key),
+                         rb_grn_inspect(self));
+            }
+            rb_key = resolved_rb_key;
+        }
+        keys[i].key = RVAL2GRNOBJECT(rb_key, &context);
+        keys[i].flags = 0;
+    }
+
+    result.table = NULL;
+    result.key_begin = 0;
+    result.key_end = n_keys - 1;
+    result.limit = 1;
+    result.flags = GRN_TABLE_GROUP_CALC_COUNT;
+    result.op = GRN_OP_OR;
+    result.max_n_subrecs = max_n_sub_records;
+    result.calc_target = NULL;
+
+    if (!NIL_P(rb_calc_target)) {
+        const char *name = NULL;
+        unsigned name_size = 0;
+        ruby_object_to_column_name(rb_calc_target, &name, &name_size);
+        result.calc_target = grn_obj_column(context, table, name, name_size);
+    }
+    if (result.calc_target) {
+        int i, n_calc_types;
+        VALUE *raw_calc_types;
+        raw_calc_types = RARRAY_PTR(rb_calc_types);
+        n_calc_types = RARRAY_LEN(rb_calc_types);
+        for (i = 0; i < n_calc_types; i++) {
+            VALUE rb_calc_type = raw_calc_types[i];
+            if (rb_grn_equal_option(rb_calc_type, "max")) {
+                result.flags |= GRN_TABLE_GROUP_CALC_MAX;
+            } else if (rb_grn_equal_option(rb_calc_type, "min")) {
+                result.flags |= GRN_TABLE_GROUP_CALC_MIN;
+            } else if (rb_grn_equal_option(rb_calc_type, "sum")) {
+                result.flags |= GRN_TABLE_GROUP_CALC_SUM;
+            } else if (rb_grn_equal_option(rb_calc_type, "average")) {
+                result.flags |= GRN_TABLE_GROUP_CALC_AVG;
+            } else {
+                grn_obj_unlink(context, result.calc_target);
+                rb_raise(rb_eArgError,
+                         "invalid calculation type: %s: "
+                         "available types: [:max, :min, :sum, :average]",
+                         rb_grn_inspect(rb_calc_type));
+            }
+        }
+    }
+
+    data.context = context;
+    data.table = table;
+    data.keys = keys;
+    data.n_keys = n_keys;
+    data.result = &result;
+    data.rc = GRN_SUCCESS;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_table_group_without_gvl,
+                                    &data);
+    rc = data.rc;
+    if (result.calc_target) {
+        grn_obj_unlink(context, result.calc_target);
+    }
+    rb_grn_context_check(context, self);
+    rb_grn_rc_check(rc, self);
+
+    return GRNOBJECT2RVAL(Qnil, context, result.table, GRN_TRUE);
+}
+
+typedef struct {
+    double sum;
+    double min;
+    double max;
+    uint64_t n_values;
+} AggregateState;
+
+typedef struct {
+    uint64_t n_records;
+    AggregateState states[];
+} AggregateGroup;
+
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    grn_id table_id;
+    const grn_id *ids;
+    long n_ids;
+    grn_obj *key_names;
+    int n_keys;
+    grn_obj *target_names;
+    int n_targets;
+    grn_hash *groups;
+    grn_rc rc;
+    char message[GRN_CTX_MSGSIZE];
+} AggregatePartition;
+
+static grn_bool
+rb_grn_table_aggregate_open_columns (grn_ctx *context,
+                                     grn_obj *table,
+                                     grn_obj *names,
+                                     grn_obj **columns,
+                                     int n_columns)
+{
+    int i;
+
+    for (i = 0; i < n_columns; i++) {
+        const char *name;
+        unsigned int name_size;
+
+        name_size = grn_vector_get_element(context, names, i,
+                                           &name, NULL, NULL);
+        columns[i] = grn_obj_column(context, table, name, name_size);
+        if (!columns[i]) {
+            if (context->rc == GRN_SUCCESS) {
+                context->rc = GRN_INVALID_ARGUMENT;
+                snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                         "[table][aggregate] no such column: <%.*s>",
+                         (int)name_size, name);
+            }
+            return GRN_FALSE;
+        }
+    }
+
+    return GRN_TRUE;
+}
+
+static void
+rb_grn_table_aggregate_close_columns (grn_ctx *context,
+                                      grn_obj **columns,
+                                      int n_columns)
+{
+    int i;
+
+    if (!columns) {
+        return;
+    }
+    for (i = 0; i < n_columns; i++) {
+        if (columns[i]) {
+            grn_obj_unlink(context, columns[i]);
+        }
+    }
+}
+
+static void
+rb_grn_table_aggregate_state_add (AggregateState *state, double value)
+{
+    if (state->n_values == 0) {
+        state->min = value;
+        state->max = value;
+    } else {
+        if (value < state->min) {
+            state->min = value;
+        }
+        if (value > state->max) {
+            state->max = value;
+        }
+    }
+    state->sum += value;
+    state->n_values++;
+}
+
+static grn_bool
+rb_grn_table_aggregate_record (grn_ctx *context,
+                               AggregatePartition *partition,
+                               grn_obj **keys,
+                               grn_obj **targets,
+                               grn_id id,
+                               grn_obj *group_key,
+                               grn_obj *value,
+                               grn_obj *float_value)
+{
+    AggregateGroup *group;
+    void *raw_group = NULL;
+    int added = 0;
+    int i;
+
+    GRN_BULK_REWIND(group_key);
+    for (i = 0; i < partition->n_keys; i++) {
+        uint32_t value_size;
+
+        GRN_BULK_REWIND(value);
+        grn_obj_get_value(context, keys[i], id, value);
+        value_size = GRN_BULK_VSIZE(value);
+        GRN_TEXT_PUT(context, group_key, &value_size, sizeof(uint32_t));
+        GRN_TEXT_PUT(context, group_key, GRN_BULK_HEAD(value), value_size);
+    }
+    if (GRN_TEXT_LEN(group_key) > GRN_TABLE_MAX_KEY_SIZE) {
+        context->rc = GRN_INVALID_ARGUMENT;
+        snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                 "[table][aggregate] too large group key: <%u>: max: <%u>",
+                 (unsigned int)GRN_TEXT_LEN(group_key),
+                 (unsigned int)GRN_TABLE_MAX_KEY_SIZE);
+        return GRN_FALSE;
+    }
+
+    grn_hash_add(context, partition->groups,
+                 GRN_TEXT_VALUE(group_key), GRN_TEXT_LEN(group_key),
+                 &raw_group, &added);
+    if (!raw_group) {
+        return GRN_FALSE;
+    }
+    group = raw_group;
+    if (added) {
+        memset(group, 0,
+               sizeof(AggregateGroup) +
+               sizeof(AggregateState) * partition->n_targets);
+    }
+    group->n_records++;
+
+    for (i = 0; i < partition->n_targets; i++) {
+        GRN_BULK_REWIND(value);
+        grn_obj_get_value(context, targets[i], id, value);
+        if (GRN_BULK_EMPTYP(value)) {
+            continue;
+        }
+        GRN_BULK_REWIND(float_value);
+        if (grn_obj_cast(context, value, float_value, GRN_FALSE) !=
+            GRN_SUCCESS) {
+            const char *name;
+            unsigned int name_size;
+
+            name_size = grn_vector_get_element(context,
+                                               partition->target_names, i,
+                                               &name, NULL, NULL);
+            context->rc = GRN_INVALID_ARGUMENT;
+            snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                     "[table][aggregate] failed to cast to Float: <%.*s>",
+                     (int)name_size, name);
+            return GRN_FALSE;
+        }
+        rb_grn_table_aggregate_state_add(&(group->states[i]),
+                                         GRN_FLOAT_VALUE(float_value));
+    }
+
+    return GRN_TRUE;
+}
+
+/*
+ * Aggregates records in the partition into `partition->groups`. It
+ * can be called without the GVL.
+ */
+static void *
+rb_grn_table_aggregate_partition (void *user_data)
+{
+    AggregatePartition *partition = user_data;
+    grn_ctx *context = partition->context;
+    grn_obj *table = partition->table;
+    grn_obj **keys = NULL;
+    grn_obj **targets = NULL;
+    grn_obj group_key;
+    grn_obj value;
+    grn_obj float_value;
+
+    GRN_TEXT_INIT(&group_key, 0);
+    GRN_VOID_INIT(&value);
+    GRN_FLOAT_INIT(&float_value, 0);
+
+    if (!table) {
+        table = grn_ctx_at(context, partition->table_id);
+        if (!table) {
+            goto exit;
+        }
+    }
+
+    keys = calloc(partition->n_keys + partition->n_targets,
+                  sizeof(grn_obj *));
+    if (!keys) {
+        context->rc = GRN_NO_MEMORY_AVAILABLE;
+        snprintf(context->errbuf, GRN_CTX_MSGSIZE,
+                 "[table][aggregate] failed to allocate columns");
+        goto exit;
+    }
+    targets = keys + partition->n_keys;
+    if (!rb_grn_table_aggregate_open_columns(context,
+                                             table,
+                                             partition->key_names,
+                                             keys,
+                                             partition->n_keys)) {
+        goto exit;
+    }
+    if (!rb_grn_table_aggregate_open_columns(context,
+                                             table,
+                                             partition->target_names,
+                                             targets,
+                                             partition->n_targets)) {
+        goto exit;
+    }
+
+    partition->groups =
+        grn_hash_create(context, NULL,
+                        GRN_TABLE_MAX_KEY_SIZE,
+                        sizeof(AggregateGroup) +
+                        sizeof(AggregateState) * partition->n_targets,
+                        GRN_OBJ_KEY_VAR_SIZE);
+    if (!partition->groups) {
+        goto exit;
+    }
+
+    if (partition->ids) {
+        long i;
+        for (i = 0; i < partition->n_ids; i++) {
+            if (context->rc != GRN_SUCCESS) {
+                break;
+            }
+            if (!rb_grn_table_aggregate_record(context,
+                                               partition,
+                                               keys,
+                                               targets,
+                                               partition->ids[i],
+                                               &group_key,
+                                               &value,
+                                               &float_value)) {
+                break;
+            }
+        }
+    } else {
+        grn_table_cursor *cursor;
+        grn_id id;
+
+        cursor = grn_table_cursor_open(context, table,
+                                       NULL, 0, NULL, 0,
+                                       0, -1, GRN_CURSOR_ASCENDING);
+        while (cursor &&
+               (id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+            if (!rb_grn_table_aggregate_record(context,
+                                               partition,
+                                               keys,
+                                               targets,
+                                               id,
+                                               &group_key,
+                                               &value,
+                                               &float_value)) {
+                break;
+            }
+        }
+        if (cursor) {
+            grn_table_cursor_close(context, cursor);
+        }
+    }
+
+exit:
+    if (keys) {
+        rb_grn_table_aggregate_close_columns(context,
+                                             keys,
+                                             partition->n_keys +
+                                             partition->n_targets);
+        free(keys);
+    }
+    GRN_OBJ_FIN(context, &group_key);
+    GRN_OBJ_FIN(context, &value);
+    GRN_OBJ_FIN(context, &float_value);
+
+    partition->rc = context->rc;
+    if (partition->rc != GRN_SUCCESS) {
+        snprintf(partition->message, GRN_CTX_MSGSIZE, "%s", context->errbuf);
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    VALUE self;
+    grn_ctx *context;
+    grn_obj *table;
+    grn_obj *domain;
+    VALUE rb_key_names;
+    VALUE rb_target_names;
+    grn_obj **key_ranges;
+    grn_obj key_names;
+    grn_obj target_names;
+    int n_keys;
+    int n_targets;
+    VALUE rb_packed_ids;
+    RbGrnWorkerPool pool;
+    AggregatePartition *partitions;
+    long n_partitions;
+    grn_hash *groups;
+    VALUE rb_result;
+} AggregateData;
+
+static void
+rb_grn_table_aggregate_collect_ids (AggregateData *data)
+{
+    grn_ctx *context = data->context;
+    grn_table_cursor *cursor;
+    grn_id id;
+
+    data->rb_packed_ids =
+        rb_str_buf_new(sizeof(grn_id) * grn_table_size(context, data->table));
+    cursor = grn_table_cursor_open(context, data->table,
+                                   NULL, 0, NULL, 0,
+                                   0, -1, GRN_CURSOR_ASCENDING);
+    rb_grn_context_check(context, data->self);
+    while ((id = grn_table_cursor_next(context, cursor)) != GRN_ID_NIL) {
+        grn_id record_id = id;
+        if (data->domain != data->table) {
+            grn_table_get_key(context, data->table, id,
+                              &record_id, sizeof(grn_id));
+        }
+        rb_str_cat(data->rb_packed_ids,
+                   (const char *)&record_id, sizeof(grn_id));
+    }
+    grn_table_cursor_close(context, cursor);
+}
+
+static void
+rb_grn_table_aggregate_merge (AggregateData *data)
+{
+    grn_ctx *context = data->context;
+    size_t group_size;
+    long i;
+
+    if (data->n_partitions == 1) {
+        data->groups = data->partitions[0].groups;
+        return;
+    }
+
+    group_size =
+        sizeof(AggregateGroup) + sizeof(AggregateState) * data->n_targets;
+    data->groups = grn_hash_create(context, NULL,
+                                   GRN_TABLE_MAX_KEY_SIZE,
+                                   group_size,
+                                   GRN_OBJ_KEY_VAR_SIZE);
+    rb_grn_context_check(context, data->self);
+    for (i = 0; i < data->n_partitions; i++) {
+        AggregatePartition *partition = &(data->partitions[i]);
+        grn_hash_cursor *cursor;
+
+        /* Partition groups are allocated by the worker context. The
+         * worker is already finished. So we can use the worker context
+         * here. */
+        cursor = grn_hash_cursor_open(partition->context, partition->groups,
+                                      NULL, 0, NULL, 0, 0, -1, 0);
+        while (cursor &&
+               grn_hash_cursor_next(partition->context, cursor) != GRN_ID_NIL) {
+            void *key;
+            unsigned int key_size;
+            void *raw_partition_group;
+            void *raw_group = NULL;
+            AggregateGroup *partition_group;
+            AggregateGroup *group;
+            int added = 0;
+            int j;
+
+            grn_hash_cursor_get_key_value(partition->context, cursor,
+                                          &key, &key_size,
+                                          &raw_partition_group);
+            partition_group = raw_partition_group;
+            grn_hash_add(context, data->groups, key, key_size,
+                         &raw_group, &added);
+            if (!raw_group) {
+                break;
+            }
+            group = raw_group;
+            if (added) {
+                memcpy(group, partition_group, group_size);
+                continue;
+            }
+            group->n_records += partition_group->n_records;
+            for (j = 0; j < data->n_targets; j++) {
+                AggregateState *state = &(group->states[j]);
+                AggregateState *partition_state = &(partition_group->states[j]);
+
+                if (partition_state->n_values == 0) {
+                    continue;
+                }
+                if (state->n_values == 0) {
+                    *state = *partition_state;
+                    continue;
+                }
+                if (partition_state->min < state->min) {
+                    state->min = partition_state->min;
+                }
+                if (partition_state->max > state->max) {
+                    state->max = partition_state->max;
+                }
+                state->sum += partition_state->sum;
+                state->n_values += partition_state->n_values;
+            }
+        }
+        if (cursor) {
+            grn_hash_cursor_close(partition->context, cursor);
+        }
+        rb_grn_context_check(context, data->self);
+    }
+}
+
+static void
+rb_grn_table_aggregate_build_result (AggregateData *data)
+{
+    grn_ctx *context = data->context;
+    grn_hash_cursor *cursor;
+    VALUE rb_keys;
+    VALUE rb_n_records;
+    VALUE rb_targets;
+    grn_obj value;
+    int i;
+
+    rb_keys = rb_ary_new_capa(data->n_keys);
+    for (i = 0; i < data->n_keys; i++) {
+        rb_ary_push(rb_keys, rb_ary_new());
+    }
+    rb_n_records = rb_ary_new();
+    rb_targets = rb_ary_new_capa(data->n_targets);
+    for (i = 0; i < data->n_targets; i++) {
+        rb_ary_push(rb_targets,
+                    rb_ary_new_from_args(4,
+                                         rb_ary_new(),
+                                         rb_ary_new(),
+                                         rb_ary_new(),
+                                         rb_ary_new()));
+    }
+    data->rb_result = rb_ary_new_from_args(3, rb_keys, rb_n_records, rb_targets);
+
+    GRN_VOID_INIT(&value);
+    cursor = grn_hash_cursor_open(context, data->groups,
+                                  NULL, 0, NULL, 0, 0, -1, 0);
+    while (cursor && grn_hash_cursor_next(context, cursor) != GRN_ID_NIL) {
+        void *key;
+        unsigned int key_size;
+        void *raw_group;
+        AggregateGroup *group;
+        const char *current;
+
+        grn_hash_cursor_get_key_value(context, cursor,
+                                      &key, &key_size, &raw_group);
+        group = raw_group;
+        current = key;
+        for (i = 0; i < data->n_keys; i++) {
+            uint32_t value_size;
+            grn_obj *range = data->key_ranges[i];
+
+            memcpy(&value_size, current, sizeof(uint32_t));
+            current += sizeof(uint32_t);
+            grn_obj_reinit(context, &value,
+                           range ? grn_obj_id(context, range) : GRN_DB_VOID,
+                           0);
+            GRN_TEXT_PUT(context, &value, current, value_size);
+            current += value_size;
+            rb_ary_push(RARRAY_AREF(rb_keys, i),
+                        GRNBULK2RVAL(context, &value, range, data->self));
+        }
+        rb_ary_push(rb_n_records, ULL2NUM(group->n_records));
+        for (i = 0; i < data->n_targets; i++) {
+            AggregateState *state = &(group->states[i]);
+            VALUE rb_target = RARRAY_AREF(rb_targets, i);
+
+            if (state->n_values == 0) {
+                rb_ary_push(RARRAY_AREF(rb_target, 0), rb_float_new(0.0));
+                rb_ary_push(RARRAY_AREF(rb_target, 1), Qnil);
+                rb_ary_push(RARRAY_AREF(rb_target, 2), Qnil);
+            } else {
+                rb_ary_push(RARRAY_AREF(rb_target, 0),
+                            rb_float_new(state->sum));
+                rb_ary_push(RARRAY_AREF(rb_target, 1),
+                            rb_float_new(state->min));
+                rb_ary_push(RARRAY_AREF(rb_target, 2),
+                            rb_float_new(state->max));
+            }
+            rb_ary_push(RARRAY_AREF(rb_target, 3),
+                        ULL2NUM(state->n_values));
+        }
+    }
+    if (cursor) {
+        grn_hash_cursor_close(context, cursor);
+    }
+    GRN_OBJ_FIN(context, &value);
+}
+
+static VALUE
+rb_grn_table_aggregate_body (VALUE user_data)
+{
+    AggregateData *data = (AggregateData *)user_data;
+    grn_ctx *context = data->context;
+    long i;
+
+    for (i = 0; i < data->n_keys; i++) {
+        VALUE rb_name = RARRAY_AREF(data->rb_key_names, i);
+        grn_vector_add_element(context, &(data->key_names),
+                               RSTRING_PTR(rb_name), RSTRING_LEN(rb_name),
+                               0, GRN_DB_TEXT);
+    }
+    for (i = 0; i < data->n_targets; i++) {
+        VALUE rb_name = RARRAY_AREF(data->rb_target_names, i);
+        grn_vector_add_element(context, &(data->target_names),
+                               RSTRING_PTR(rb_name), RSTRING_LEN(rb_name),
+                               0, GRN_DB_TEXT);
+    }
+
+    if (data->n_partitions == 1) {
+        AggregatePartition *partition = &(data->partitions[0]);
+
+        partition->context = context;
+        partition->table = data->table;
+        partition->key_names = &(data->key_names);
+        partition->n_keys = data->n_keys;
+        partition->target_names = &(data->target_names);
+        partition->n_targets = data->n_targets;
+        partition->rc = GRN_SUCCESS;
+        rb_grn_context_call_without_gvl(context,
+                                        rb_grn_table_aggregate_partition,
+                                        partition);
+        rb_grn_context_check(context, data->self);
+    } else {
+        const grn_id *ids;
+        long n_ids, offset;
+
+        rb_grn_table_aggregate_collect_ids(data);
+        ids = (const grn_id *)RSTRING_PTR(data->rb_packed_ids);
+        n_ids = RSTRING_LEN(data->rb_packed_ids) / sizeof(grn_id);
+        offset = 0;
+        /* Workers must not outlive this function because they refer
+         * data->rb_packed_ids and names. */
+        for (i = 0; i < data->n_partitions; i++) {
+            AggregatePartition *partition = &(data->partitions[i]);
+            long n_partition_ids;
+
+            n_partition_ids = n_ids / data->n_partitions;
+            if (i < n_ids % data->n_partitions) {
+                n_partition_ids++;
+            }
+            partition->table = NULL;
+            partition->table_id = grn_obj_id(context, data->domain);
+            partition->ids = ids + offset;
+            partition->n_ids = n_partition_ids;
+            partition->key_names = &(data->key_names);
+            partition->n_keys = data->n_keys;
+            partition->target_names = &(data->target_names);
+            partition->n_targets = data->n_targets;
+            partition->rc = GRN_SUCCESS;
+            offset += n_partition_ids;
+
+            partition->context =
+                rb_grn_worker_pool_get_context(&(data->pool), i);
+            rb_grn_worker_pool_spawn(&(data->pool), i,
+                                     rb_grn_table_aggregate_partition,
+                                     partition);
+        }
+        rb_grn_worker_pool_join(&(data->pool));
+    }
+
+    for (i = 0; i < data->n_partitions; i++) {
+        AggregatePartition *partition = &(data->partitions[i]);
+        if (partition->rc != GRN_SUCCESS) {
+            rb_raise(rb_grn_rc_to_exception(partition->rc),
+                     "failed to aggregate records: %s: %" PRIsVALUE,
+                     partition->message,
+                     data->self);
+        }
+    }
+
+    rb_grn_table_aggregate_merge(data);
+    rb_grn_table_aggregate_build_result(data);
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_aggregate_ensure (VALUE user_data)
+{
+    AggregateData *data = (AggregateData *)user_data;
+    long i;
+
+    /* Groups are owned by worker contexts. They must be closed after
+     * workers are finished and before worker contexts are freed. */
+    rb_grn_worker_pool_stop(&(data->pool));
+    if (data->groups && data->n_partitions > 1) {
+        grn_hash_close(data->context, data->groups);
+    }
+    for (i = 0; i < data->n_partitions; i++) {
+        AggregatePartition *partition = &(data->partitions[i]);
+        if (partition->groups) {
+            grn_hash_close(partition->context, partition->groups);
+        }
+    }
+    rb_grn_worker_pool_fin(&(data->pool));
+    xfree(data->partitions);
+    GRN_OBJ_FIN(data->context, &(data->key_names));
+    GRN_OBJ_FIN(data->context, &(data->target_names));
+
+    return Qnil;
+}
+
+/*
+ * Returns the persistent table that workers can refer. It returns
+ * `NULL` when records can't be aggregated in parallel.
+ *
+ * Workers refer the target table or the table of a result of
+ * {Groonga::Table#select} by their own contexts. Pseudo columns such
+ * as `_key` and `_score` aren't used for parallel aggregation because
+ * they have different meaning between a result and its source table.
+ */
+static grn_obj *
+rb_grn_table_aggregate_parallel_domain (grn_ctx *context,
+                                        grn_obj *table,
+                                        VALUE rb_key_names,
+                                        VALUE rb_target_names)
+{
+    grn_obj *domain = NULL;
+    VALUE rb_names[2];
+    int i;
+    long j;
+
+    if (table->header.flags & GRN_OBJ_PERSISTENT) {
+        domain = table;
+    } else if (table->header.flags & GRN_OBJ_WITH_SUBREC) {
+        domain = grn_ctx_at(context, table->header.domain);
+        if (!(domain &&
+              grn_obj_is_table(context, domain) &&
+              (domain->header.flags & GRN_OBJ_PERSISTENT))) {
+            return NULL;
+        }
+    } else {
+        return NULL;
     }
 
-    keys = ALLOCA_N(grn_table_sort_key, n_keys);
-    for (i = 0; i < n_keys; i++) {
-        VALUE rb_sort_options, rb_key;
+    rb_names[0] = rb_key_names;
+    rb_names[1] = rb_target_names;
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < RARRAY_LEN(rb_names[i]); j++) {
+            VALUE rb_name = RARRAY_AREF(rb_names[i], j);
+            grn_obj *column;
 
-        if (RVAL2CBOOL(rb_obj_is_kind_of(rb_group_keys[i], rb_cHash))) {
-            rb_sort_options = rb_group_keys[i];
-        } else {
-            rb_sort_options = rb_hash_new();
-            rb_hash_aset(rb_sort_options,
-                         RB_GRN_INTERN("key"),
-                         rb_group_keys[i]);
-        }
-        rb_grn_scan_options(rb_sort_options,
-                            "key", &rb_key,
-                            NULL);
-        if (RVAL2CBOOL(rb_obj_is_kind_of(rb_key, rb_cString))) {
-            VALUE resolved_rb_key;
-            resolved_rb_key = rb_grn_table_get_column(self, rb_key);
-            if (NIL_P(resolved_rb_key)) {
-                rb_raise(rb_eArgError,
-                         "unknown group key: <%s>: <%s>",
-                         rb_grn_inspect(rb_key),
-                         rb_grn_inspect(self));
+            if (RSTRING_LEN(rb_name) > 0 && RSTRING_PTR(rb_name)[0] == '_') {
+                return NULL;
             }
-            rb_key = resolved_rb_key;
+            column = grn_obj_column(context, domain,
+                                    RSTRING_PTR(rb_name),
+                                    RSTRING_LEN(rb_name));
+            if (!column) {
+                return NULL;
+            }
+            grn_obj_unlink(context, column);
         }
-        keys[i].key = RVAL2GRNOBJECT(rb_key, &context);
-        keys[i].flags = 0;
     }
 
-    result.table = NULL;
-    result.key_begin = 0;
-    result.key_end = n_keys - 1;
-    result.limit = 1;
-    result.flags = GRN_TABLE_GROUP_CALC_COUNT;
-    result.op = GRN_OP_OR;
-    result.max_n_subrecs = max_n_sub_records;
-    result.calc_target = NULL;
+    return domain;
+}
 
-    if (!NIL_P(rb_calc_target)) {
-        const char *name = NULL;
-        unsigned name_size = 0;
-        ruby_object_to_column_name(rb_calc_target, &name, &name_size);
-        result.calc_target = grn_obj_column(context, table, name, name_size);
+/*
+ * @api private
+ *
+ * Groups records by `key_names` and computes sum, min, max and the
+ * number of values of each target in one pass. It's the backend of
+ * {Groonga::Table#aggregate}.
+ *
+ * @overload aggregate_native(key_names, target_names, n_workers)
+ *   @return [::Array] `[key_values, n_records, target_values]`.
+ *     `key_values` is an Array of values for each key.
+ *     `target_values` is an Array of `[sums, mins, maxs, n_values]`
+ *     for each target.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_table_aggregate_native (VALUE self,
+                               VALUE rb_key_names,
+                               VALUE rb_target_names,
+                               VALUE rb_n_workers)
+{
+    AggregateData data;
+    grn_ctx *context = NULL;
+    grn_obj *table;
+    long i, n_workers;
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL,
+                             NULL, NULL, NULL,
+                             NULL);
+
+    rb_key_names = rb_grn_convert_to_array(rb_key_names);
+    rb_target_names = rb_grn_convert_to_array(rb_target_names);
+    n_workers = NIL_P(rb_n_workers) ? 1 : NUM2LONG(rb_n_workers);
+
+    data.n_keys = RARRAY_LEN(rb_key_names);
+    data.n_targets = RARRAY_LEN(rb_target_names);
+    if (data.n_keys == 0) {
+        rb_raise(rb_eArgError, "aggregate keys are missing: %" PRIsVALUE, self);
     }
-    if (result.calc_target) {
-        int i, n_calc_types;
-        VALUE *raw_calc_types;
-        raw_calc_types = RARRAY_PTR(rb_calc_types);
-        n_calc_types = RARRAY_LEN(rb_calc_types);
-        for (i = 0; i < n_calc_types; i++) {
-            VALUE rb_calc_type = raw_calc_types[i];
-            if (rb_grn_equal_option(rb_calc_type, "max")) {
-                result.flags |= GRN_TABLE_GROUP_CALC_MAX;
-            } else if (rb_grn_equal_option(rb_calc_type, "min")) {
-                result.flags |= GRN_TABLE_GROUP_CALC_MIN;
-            } else if (rb_grn_equal_option(rb_calc_type, "sum")) {
-                result.flags |= GRN_TABLE_GROUP_CALC_SUM;
-            } else if (rb_grn_equal_option(rb_calc_type, "average")) {
-                result.flags |= GRN_TABLE_GROUP_CALC_AVG;
-            } else {
-                grn_obj_unlink(context, result.calc_target);
-                rb_raise(rb_eArgError,
-                         "invalid calculation type: %s: "
-                         "available types: [:max, :min, :sum, :average]",
-                         rb_grn_inspect(rb_calc_type));
-            }
+    data.key_ranges = ALLOCA_N(grn_obj *, data.n_keys);
+    for (i = 0; i < data.n_keys; i++) {
+        VALUE rb_name = rb_grn_convert_to_string(RARRAY_AREF(rb_key_names, i));
+        VALUE rb_column;
+        grn_obj *column;
+
+        rb_column = rb_grn_table_get_column_surely(self, rb_name);
+        column = RVAL2GRNOBJECT(rb_column, &context);
+        if (grn_obj_is_vector_column(context, column)) {
+            rb_raise(rb_eArgError,
+                     "vector column can't be an aggregate key: %" PRIsVALUE,
+                     rb_column);
         }
+        data.key_ranges[i] = grn_ctx_at(context,
+                                        grn_obj_get_range(context, column));
+        rb_ary_store(rb_key_names, i, rb_name);
     }
-
-    rc = grn_table_group(context, table, keys, n_keys, &result, 1);
-    if (result.calc_target) {
-        grn_obj_unlink(context, result.calc_target);
+    for (i = 0; i < data.n_targets; i++) {
+        VALUE rb_name =
+            rb_grn_convert_to_string(RARRAY_AREF(rb_target_names, i));
+        rb_grn_table_get_column_surely(self, rb_name);
+        rb_ary_store(rb_target_names, i, rb_name);
     }
-    rb_grn_context_check(context, self);
-    rb_grn_rc_check(rc, self);
 
-    return GRNOBJECT2RVAL(Qnil, context, result.table, GRN_TRUE);
+    data.self = self;
+    data.context = context;
+    data.table = table;
+    data.domain = NULL;
+    if (n_workers > 1 && grn_table_size(context, table) > 1) {
+        data.domain = rb_grn_table_aggregate_parallel_domain(context,
+                                                             table,
+                                                             rb_key_names,
+                                                             rb_target_names);
+    }
+    data.rb_key_names = rb_key_names;
+    data.rb_target_names = rb_target_names;
+    data.rb_packed_ids = Qnil;
+    data.n_partitions = data.domain ? n_workers : 1;
+    data.groups = NULL;
+    data.rb_result = Qnil;
+    GRN_TEXT_INIT(&(data.key_names), GRN_OBJ_VECTOR);
+    GRN_TEXT_INIT(&(data.target_names), GRN_OBJ_VECTOR);
+    data.partitions = ZALLOC_N(AggregatePartition, data.n_partitions);
+    rb_grn_worker_pool_init(&(data.pool),
+                            context,
+                            data.n_partitions > 1 ? data.n_partitions : 0);
+    rb_ensure(rb_grn_table_aggregate_body, (VALUE)&data,
+              rb_grn_table_aggregate_ensure, (VALUE)&data);
+    RB_GC_GUARD(data.rb_packed_ids);
+    RB_GC_GUARD(rb_key_names);
+    RB_GC_GUARD(rb_target_names);
+
+    return data.rb_result;
 }
 
 /*
@@ -2273,6 +4034,25 @@ rb_grn_table_locked_p (VALUE self)
     return CBOOL2RVAL(grn_obj_is_locked(context, table));
 }
 
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    grn_obj *expression;
+    grn_obj *result;
+    grn_operator operator;
+} SelectData;
+
+static void *
+rb_grn_table_select_without_gvl (void *user_data)
+{
+    SelectData *data = user_data;
+
+    grn_table_select(data->context, data->table, data->expression,
+                     data->result, data->operator);
+
+    return NULL;
+}
+
 /*
  * _table_ からブロックまたは文字列で指定した条件にマッチする
  * レコードを返す。返されたテーブルには +expression+ という特
@@ -2417,6 +4197,8 @@ rb_grn_table_select (int argc, VALUE *argv, VALUE self)
     VALUE rb_allow_pragma, rb_allow_column, rb_allow_update, rb_allow_leading_not;
     VALUE rb_default_column;
     VALUE rb_expression = Qnil, builder;
+    VALUE rb_expression_cache = Qnil, rb_expression_cache_key = Qnil;
+    SelectData data;
 
     rb_scan_args(argc, argv, "02", &condition_or_options, &options);
 
@@ -2471,6 +4253,48 @@ rb_grn_table_select (int argc, VALUE *argv, VALUE self)
         result = RVAL2GRNTABLE(rb_result, &context);
     }
 
+    if (NIL_P(rb_expression) && !NIL_P(rb_query)) {
+        VALUE rb_context = rb_iv_get(self, "@context");
+        /* Expressions for temporary tables such as select results
+         * aren't cached. They would be kept until they're evicted. */
+        if (!NIL_P(rb_context) &&
+            (table->header.flags & GRN_OBJ_PERSISTENT)) {
+            rb_expression_cache = rb_iv_get(rb_context, "@expression_cache");
+        }
+        if (!NIL_P(rb_expression_cache)) {
+            /* The table is referred by ID not to keep the table
+             * object alive. */
+            VALUE rb_key_values[] = {
+                UINT2NUM(grn_obj_id(context, table)),
+                rb_query,
+                rb_name,
+                rb_syntax,
+                rb_allow_pragma,
+                rb_allow_column,
+                rb_allow_update,
+                rb_allow_leading_not,
+                rb_default_column,
+            };
+            size_t i, n_key_values;
+
+            /* The caller may change the Strings in place later. The
+             * cached key must not be changed. */
+            n_key_values = sizeof(rb_key_values) / sizeof(rb_key_values[0]);
+            for (i = 0; i < n_key_values; i++) {
+                if (RB_TYPE_P(rb_key_values[i], T_STRING)) {
+                    rb_key_values[i] = rb_str_new_frozen(rb_key_values[i]);
+                }
+            }
+            rb_expression_cache_key =
+                rb_ary_new_from_values(n_key_values, rb_key_values);
+            rb_obj_freeze(rb_expression_cache_key);
+            rb_expression = rb_funcall(rb_expression_cache,
+                                       id_array_reference,
+                                       1,
+                                       rb_expression_cache_key);
+        }
+    }
+
     if (NIL_P(rb_expression)) {
       builder = rb_grn_record_expression_builder_new(self, rb_name);
       rb_funcall(builder, rb_intern("query="), 1, rb_query);
@@ -2481,12 +4305,26 @@ rb_grn_table_select (int argc, VALUE *argv, VALUE self)
       rb_funcall(builder, rb_intern("allow_leading_not="), 1, rb_allow_leading_not);
       rb_funcall(builder, rb_intern("default_column="), 1, rb_default_column);
       rb_expression = rb_grn_record_expression_builder_build(builder);
+      if (!NIL_P(rb_expression_cache_key)) {
+          rb_funcall(rb_expression_cache,
+                     id_array_set,
+                     2,
+                     rb_expression_cache_key,
+                     rb_expression);
+      }
     }
     rb_grn_object_deconstruct(RB_GRN_OBJECT(RTYPEDDATA_DATA(rb_expression)),
                               &expression, NULL,
                               NULL, NULL, NULL, NULL);
 
-    grn_table_select(context, table, expression, result, operator);
+    data.context = context;
+    data.table = table;
+    data.expression = expression;
+    data.result = result;
+    data.operator = operator;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_table_select_without_gvl,
+                                    &data);
     rb_grn_context_check(context, self);
 
     rb_attr(rb_singleton_class(rb_result),
@@ -2715,53 +4553,434 @@ rb_grn_table_defrag (int argc, VALUE *argv, VALUE self)
     VALUE options, rb_threshold;
     int threshold = 0;
 
-    rb_scan_args(argc, argv, "01", &options);
-    rb_grn_scan_options(options,
-                        "threshold", &rb_threshold,
+    rb_scan_args(argc, argv, "01", &options);
+    rb_grn_scan_options(options,
+                        "threshold", &rb_threshold,
+                        NULL);
+    if (!NIL_P(rb_threshold)) {
+        threshold = NUM2INT(rb_threshold);
+    }
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL, NULL,
+                             NULL, NULL,
+                             NULL);
+    n_segments = grn_obj_defrag(context, table, threshold);
+    rb_grn_context_check(context, self);
+
+    return INT2NUM(n_segments);
+}
+
+/*
+ * Renames the table to name.
+ *
+ * @overload rename(name)
+ *   @param name [String] the new name
+ *   @since 1.3.0
+ */
+static VALUE
+rb_grn_table_rename (VALUE self, VALUE rb_name)
+{
+    int rc;
+    grn_ctx *context;
+    grn_obj *table;
+    char *name;
+    int name_size;
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL, NULL,
+                             NULL, NULL,
+                             NULL);
+
+    name = StringValueCStr(rb_name);
+    name_size = RSTRING_LEN(rb_name);
+
+    rc = grn_table_rename(context, table, name, name_size);
+    rb_grn_context_check(context, self);
+    rb_grn_rc_check(rc, self);
+
+    return self;
+}
+
+typedef struct {
+    VALUE self;
+    grn_ctx *context;
+    grn_obj *table;
+    grn_id key_type_id;
+    grn_obj *key_type;
+    grn_obj key;
+    VALUE rb_columns;
+    long key_index;
+    VALUE rb_rows;
+    VALUE rb_row;
+    grn_id id;
+    VALUE (*load_row)(VALUE user_data);
+    VALUE rb_errors;
+} LoadData;
+
+static grn_bool
+rb_grn_table_load_key_name_p (VALUE rb_name)
+{
+    if (RB_TYPE_P(rb_name, RUBY_T_SYMBOL)) {
+        rb_name = rb_sym2str(rb_name);
+    }
+    if (!RB_TYPE_P(rb_name, RUBY_T_STRING)) {
+        return GRN_FALSE;
+    }
+    return RSTRING_LEN(rb_name) == strlen("_key") &&
+        memcmp(RSTRING_PTR(rb_name), "_key", strlen("_key")) == 0;
+}
+
+static VALUE
+rb_grn_table_load_resolve_column (LoadData *data, VALUE rb_name)
+{
+    VALUE rb_column;
+
+    rb_column = rb_grn_table_get_column_surely(data->self, rb_name);
+    if (!RVAL2CBOOL(rb_obj_is_kind_of(rb_column, rb_cGrnDataColumn))) {
+        rb_raise(rb_eArgError,
+                 "only data columns and _key can be loaded: "
+                 "%" PRIsVALUE ": %" PRIsVALUE,
+                 rb_name,
+                 data->self);
+    }
+    return rb_column;
+}
+
+static grn_id
+rb_grn_table_load_add (LoadData *data, VALUE rb_key)
+{
+    grn_ctx *context = data->context;
+    grn_id id;
+
+    if (data->table->header.type == GRN_TABLE_NO_KEY) {
+        id = grn_table_add(context, data->table, NULL, 0, NULL);
+    } else {
+        if (NIL_P(rb_key)) {
+            rb_raise(rb_eArgError,
+                     "_key is missing: %" PRIsVALUE ": %" PRIsVALUE,
+                     data->rb_row,
+                     data->self);
+        }
+        GRN_BULK_REWIND(&(data->key));
+        RVAL2GRNKEY(rb_key, context, &(data->key),
+                    data->key_type_id, data->key_type, data->self);
+        id = grn_table_add(context, data->table,
+                           GRN_BULK_HEAD(&(data->key)),
+                           GRN_BULK_VSIZE(&(data->key)),
+                           NULL);
+    }
+    rb_grn_context_check(context, data->self);
+    if (id == GRN_ID_NIL) {
+        rb_raise(rb_eGrnError,
+                 "failed to add a record: %" PRIsVALUE ": %" PRIsVALUE,
+                 data->rb_row,
+                 data->self);
+    }
+
+    return id;
+}
+
+static void
+rb_grn_table_load_set (LoadData *data,
+                       VALUE rb_column,
+                       grn_id id,
+                       VALUE rb_value)
+{
+    RbGrnColumn *rb_grn_column;
+    grn_ctx *context;
+    grn_obj *column;
+    grn_obj *value;
+    grn_id range_id;
+    grn_obj *range;
+    grn_rc rc;
+
+    rb_grn_column = RB_GRN_COLUMN(RTYPEDDATA_DATA(rb_column));
+    rb_grn_column_deconstruct(rb_grn_column, &column, &context,
+                              NULL, NULL,
+                              &value, &range_id, &range);
+    if (column->header.type == GRN_COLUMN_FIX_SIZE) {
+        RVAL2GRNVALUE(rb_value, context, value, range_id, range);
+        rc = grn_obj_set_value(context, column, id, value, GRN_OBJ_SET);
+        rb_grn_context_check(context, rb_column);
+        rb_grn_rc_check(rc, rb_column);
+    } else if (grn_column_get_flags(context, column) & GRN_OBJ_WITH_WEIGHT) {
+        rb_funcall(rb_column, id_array_set, 2, UINT2NUM(id), rb_value);
+    } else {
+        rb_grn_object_set_raw(RB_GRN_OBJECT(rb_grn_column),
+                              id, rb_value, GRN_OBJ_SET, rb_column);
+    }
+}
+
+static VALUE
+rb_grn_table_load_row (VALUE user_data)
+{
+    LoadData *data = (LoadData *)user_data;
+    VALUE rb_row;
+    VALUE rb_key = Qnil;
+    grn_id id;
+    long i, n;
+
+    rb_row = rb_grn_convert_to_array(data->rb_row);
+    n = RARRAY_LEN(data->rb_columns);
+    if (RARRAY_LEN(rb_row) != n) {
+        rb_raise(rb_eArgError,
+                 "the number of values must be the same as columns: "
+                 "<%ld>: %" PRIsVALUE ": %" PRIsVALUE,
+                 n,
+                 rb_row,
+                 data->self);
+    }
+    if (data->key_index >= 0) {
+        rb_key = RARRAY_AREF(rb_row, data->key_index);
+    }
+    id = rb_grn_table_load_add(data, rb_key);
+    for (i = 0; i < n; i++) {
+        if (i == data->key_index) {
+            continue;
+        }
+        rb_grn_table_load_set(data,
+                              RARRAY_AREF(data->rb_columns, i),
+                              id,
+                              RARRAY_AREF(rb_row, i));
+    }
+
+    return Qnil;
+}
+
+static int
+rb_grn_table_load_record_set (VALUE rb_name, VALUE rb_value, VALUE user_data)
+{
+    LoadData *data = (LoadData *)user_data;
+    VALUE rb_column;
+
+    if (rb_grn_table_load_key_name_p(rb_name)) {
+        return ST_CONTINUE;
+    }
+
+    rb_column = rb_hash_lookup(data->rb_columns, rb_name);
+    if (NIL_P(rb_column)) {
+        rb_column = rb_grn_table_load_resolve_column(data, rb_name);
+        rb_hash_aset(data->rb_columns, rb_name, rb_column);
+    }
+    rb_grn_table_load_set(data, rb_column, data->id, rb_value);
+
+    return ST_CONTINUE;
+}
+
+static VALUE
+rb_grn_table_load_record (VALUE user_data)
+{
+    LoadData *data = (LoadData *)user_data;
+    VALUE rb_record;
+    VALUE rb_key;
+
+    rb_record = rb_convert_type(data->rb_row, RUBY_T_HASH, "Hash", "to_hash");
+    rb_key = rb_hash_lookup2(rb_record, rb_str_new_cstr("_key"), Qundef);
+    if (rb_key == Qundef) {
+        rb_key = rb_hash_lookup(rb_record, ID2SYM(rb_intern("_key")));
+    }
+    data->id = rb_grn_table_load_add(data, rb_key);
+    rb_hash_foreach(rb_record, rb_grn_table_load_record_set, (VALUE)data);
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_load_body (VALUE user_data)
+{
+    LoadData *data = (LoadData *)user_data;
+    long i, n;
+    long n_loaded = 0;
+
+    n = RARRAY_LEN(data->rb_rows);
+    for (i = 0; i < n; i++) {
+        data->rb_row = RARRAY_AREF(data->rb_rows, i);
+        if (NIL_P(data->rb_errors)) {
+            data->load_row((VALUE)data);
+        } else {
+            int state = 0;
+            rb_protect(data->load_row, (VALUE)data, &state);
+            if (state != 0) {
+                VALUE rb_error = rb_errinfo();
+                rb_set_errinfo(Qnil);
+                if (!RVAL2CBOOL(rb_obj_is_kind_of(rb_error,
+                                                  rb_eStandardError))) {
+                    rb_jump_tag(state);
+                }
+                rb_ary_push(data->rb_errors,
+                            rb_ary_new_from_args(2, LONG2NUM(i), rb_error));
+                continue;
+            }
+        }
+        n_loaded++;
+    }
+
+    return LONG2NUM(n_loaded);
+}
+
+static VALUE
+rb_grn_table_load_ensure (VALUE user_data)
+{
+    LoadData *data = (LoadData *)user_data;
+
+    GRN_OBJ_FIN(data->context, &(data->key));
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_load (VALUE self,
+                   VALUE rb_columns,
+                   VALUE rb_rows,
+                   VALUE rb_options,
+                   VALUE (*load_row)(VALUE user_data))
+{
+    LoadData data;
+    VALUE rb_errors;
+
+    rb_grn_scan_options(rb_options,
+                        "errors", &rb_errors,
                         NULL);
-    if (!NIL_P(rb_threshold)) {
-        threshold = NUM2INT(rb_threshold);
+    if (!NIL_P(rb_errors) && !RB_TYPE_P(rb_errors, RUBY_T_ARRAY)) {
+        rb_raise(rb_eArgError,
+                 ":errors must be an Array: %" PRIsVALUE ": %" PRIsVALUE,
+                 rb_errors,
+                 self);
     }
 
-    rb_grn_table_deconstruct(SELF(self), &table, &context,
-                             NULL, NULL, NULL,
+    data.self = self;
+    rb_grn_table_deconstruct(SELF(self), &(data.table), &(data.context),
                              NULL, NULL,
+                             NULL, NULL, NULL,
                              NULL);
-    n_segments = grn_obj_defrag(context, table, threshold);
-    rb_grn_context_check(context, self);
+    data.key_type_id = data.table->header.domain;
+    data.key_type = grn_ctx_at(data.context, data.key_type_id);
+    data.rb_columns = rb_columns;
+    data.key_index = -1;
+    data.rb_rows = rb_grn_convert_to_array(rb_rows);
+    data.rb_row = Qnil;
+    data.id = GRN_ID_NIL;
+    data.load_row = load_row;
+    data.rb_errors = rb_errors;
+
+    if (load_row == rb_grn_table_load_row) {
+        long i, n;
 
-    return INT2NUM(n_segments);
+        n = RARRAY_LEN(rb_columns);
+        for (i = 0; i < n; i++) {
+            VALUE rb_name = RARRAY_AREF(rb_columns, i);
+            if (rb_grn_table_load_key_name_p(rb_name)) {
+                data.key_index = i;
+                rb_ary_store(rb_columns, i, Qnil);
+            } else {
+                rb_ary_store(rb_columns, i,
+                             rb_grn_table_load_resolve_column(&data, rb_name));
+            }
+        }
+    }
+
+    GRN_OBJ_INIT(&(data.key), GRN_BULK, 0, data.key_type_id);
+    return rb_ensure(rb_grn_table_load_body, (VALUE)&data,
+                     rb_grn_table_load_ensure, (VALUE)&data);
 }
 
 /*
- * Renames the table to name.
- *
- * @overload rename(name)
- *   @param name [String] the new name
- *   @since 1.3.0
+ * Loads many records at once. Columns are resolved only once
+ * and values are set in one C loop. It's faster than calling
+ * {Groonga::TableKeySupport#add} with values for each record.
+ *
+ * If a record with the same key already exists, its values are
+ * overwritten.
+ *
+ * @example Load users.
+ *
+ *   users = Groonga["Users"]
+ *   users.load_rows(["_key", "name", "age"],
+ *                   [
+ *                     ["alice", "Alice", 29],
+ *                     ["bob", "Bob", 41],
+ *                   ])
+ *
+ * @example Collect errors instead of raising.
+ *
+ *   errors = []
+ *   users.load_rows(["_key", "age"],
+ *                   [["alice", 29], ["bob", "unknown"]],
+ *                   :errors => errors)
+ *   p errors # -> [[1, #<Groonga::InvalidArgument ...>]]
+ *
+ * @overload load_rows(column_names, rows, options={})
+ *   @param column_names [::Array<String, Symbol>] The names of
+ *     the columns. `"_key"` is for the key of the record. It's
+ *     required for tables with key.
+ *   @param rows [::Array<::Array<Object>>] The values of records.
+ *     Each row has values in the order of `column_names`.
+ *   @param options [::Hash] The name and value pairs.
+ *   @option options [::Array, nil] :errors (nil)
+ *     If this is `nil`, the first error is raised. Otherwise,
+ *     loading is continued on error and `[index_of_row, error]`
+ *     is appended to it for each failed row. Values that are set
+ *     before the error aren't reverted.
+ *
+ *   @return [Integer] The number of successfully loaded rows.
+ *
+ * @since 15.0.5
  */
 static VALUE
-rb_grn_table_rename (VALUE self, VALUE rb_name)
+rb_grn_table_load_rows (int argc, VALUE *argv, VALUE self)
 {
-    int rc;
-    grn_ctx *context;
-    grn_obj *table;
-    char *name;
-    int name_size;
+    VALUE rb_column_names;
+    VALUE rb_rows;
+    VALUE rb_options;
 
-    rb_grn_table_deconstruct(SELF(self), &table, &context,
-                             NULL, NULL, NULL,
-                             NULL, NULL,
-                             NULL);
+    rb_scan_args(argc, argv, "21", &rb_column_names, &rb_rows, &rb_options);
 
-    name = StringValueCStr(rb_name);
-    name_size = RSTRING_LEN(rb_name);
+    return rb_grn_table_load(self,
+                             rb_ary_dup(rb_grn_convert_to_array(rb_column_names)),
+                             rb_rows,
+                             rb_options,
+                             rb_grn_table_load_row);
+}
 
-    rc = grn_table_rename(context, table, name, name_size);
-    rb_grn_context_check(context, self);
-    rb_grn_rc_check(rc, self);
+/*
+ * Loads many records at once. It's the same as {#load_rows}
+ * but each record is a `Hash` of column name and value pairs.
+ * Columns are resolved only once for each name.
+ *
+ * @example Load users.
+ *
+ *   users = Groonga["Users"]
+ *   users.load_records([
+ *                        {"_key" => "alice", "age" => 29},
+ *                        {"_key" => "bob", "name" => "Bob"},
+ *                      ])
+ *
+ * @overload load_records(records, options={})
+ *   @param records [::Array<::Hash>] The records. `"_key"` is
+ *     for the key of the record. It's required for tables with
+ *     key.
+ *   @param options [::Hash] The name and value pairs.
+ *   @option options [::Array, nil] :errors (nil)
+ *     See {#load_rows}.
+ *
+ *   @return [Integer] The number of successfully loaded records.
+ *
+ * @since 15.0.5
+ */
+static VALUE
+rb_grn_table_load_records (int argc, VALUE *argv, VALUE self)
+{
+    VALUE rb_records;
+    VALUE rb_options;
 
-    return self;
+    rb_scan_args(argc, argv, "11", &rb_records, &rb_options);
+
+    return rb_grn_table_load(self,
+                             rb_hash_new(),
+                             rb_records,
+                             rb_options,
+                             rb_grn_table_load_record);
 }
 
 /*
@@ -2809,6 +5028,552 @@ rb_grn_table_load_arrow (VALUE self, VALUE rb_path)
     return self;
 }
 
+#define LOAD_ARROW_STREAM_CHUNK_SIZE (1024 * 1024)
+
+typedef struct {
+    grn_ctx *context;
+    const char *chunk;
+    unsigned int chunk_size;
+    int flags;
+} LoadArrowStreamSendData;
+
+typedef struct {
+    VALUE self;
+    grn_ctx *context;
+    VALUE rb_input;
+} LoadArrowStreamData;
+
+static void *
+rb_grn_table_load_arrow_stream_send_without_gvl (void *user_data)
+{
+    LoadArrowStreamSendData *data = user_data;
+
+    grn_ctx_send(data->context, data->chunk, data->chunk_size, data->flags);
+
+    return NULL;
+}
+
+static void
+rb_grn_table_load_arrow_stream_send (grn_ctx *context,
+                                     const char *chunk,
+                                     unsigned int chunk_size,
+                                     int flags)
+{
+    LoadArrowStreamSendData data;
+
+    data.context = context;
+    data.chunk = chunk;
+    data.chunk_size = chunk_size;
+    data.flags = flags;
+    rb_grn_context_call_without_gvl(context,
+                                    rb_grn_table_load_arrow_stream_send_without_gvl,
+                                    &data);
+}
+
+static void
+rb_grn_table_load_arrow_stream_send_string (LoadArrowStreamData *data,
+                                            VALUE rb_chunk)
+{
+    long offset, size;
+
+    StringValue(rb_chunk);
+    size = RSTRING_LEN(rb_chunk);
+    rb_str_locktmp(rb_chunk);
+    for (offset = 0; offset < size; offset += LOAD_ARROW_STREAM_CHUNK_SIZE) {
+        long chunk_size = size - offset;
+        if (chunk_size > LOAD_ARROW_STREAM_CHUNK_SIZE) {
+            chunk_size = LOAD_ARROW_STREAM_CHUNK_SIZE;
+        }
+        rb_grn_table_load_arrow_stream_send(data->context,
+                                            RSTRING_PTR(rb_chunk) + offset,
+                                            chunk_size,
+                                            GRN_CTX_MORE);
+        if (data->context->rc != GRN_SUCCESS) {
+            break;
+        }
+    }
+    rb_str_unlocktmp(rb_chunk);
+    rb_grn_context_check(data->context, data->self);
+}
+
+static VALUE
+rb_grn_table_load_arrow_stream_body (VALUE user_data)
+{
+    LoadArrowStreamData *data = (LoadArrowStreamData *)user_data;
+    VALUE rb_input = data->rb_input;
+    VALUE rb_chunk_size = INT2NUM(LOAD_ARROW_STREAM_CHUNK_SIZE);
+
+    if (RB_TYPE_P(rb_input, RUBY_T_STRING)) {
+        rb_grn_table_load_arrow_stream_send_string(data, rb_input);
+    } else if (rb_respond_to(rb_input, rb_intern("read"))) {
+        while (GRN_TRUE) {
+            VALUE rb_chunk;
+            rb_chunk = rb_funcall(rb_input, rb_intern("read"), 1,
+                                  rb_chunk_size);
+            if (NIL_P(rb_chunk)) {
+                break;
+            }
+            rb_grn_table_load_arrow_stream_send_string(data, rb_chunk);
+        }
+    } else if (rb_respond_to(rb_input, rb_intern("get_string"))) {
+        long offset, size;
+
+        size = NUM2LONG(rb_funcall(rb_input, rb_intern("size"), 0));
+        for (offset = 0;
+             offset < size;
+             offset += LOAD_ARROW_STREAM_CHUNK_SIZE) {
+            long chunk_size = size - offset;
+            VALUE rb_chunk;
+
+            if (chunk_size > LOAD_ARROW_STREAM_CHUNK_SIZE) {
+                chunk_size = LOAD_ARROW_STREAM_CHUNK_SIZE;
+            }
+            rb_chunk = rb_funcall(rb_input, rb_intern("get_string"), 2,
+                                  LONG2NUM(offset), LONG2NUM(chunk_size));
+            rb_grn_table_load_arrow_stream_send_string(data, rb_chunk);
+        }
+    } else {
+        rb_raise(rb_eArgError,
+                 "input must be String, IO or IO::Buffer: %" PRIsVALUE,
+                 rb_input);
+    }
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_load_arrow_stream_ensure (VALUE user_data)
+{
+    LoadArrowStreamData *data = (LoadArrowStreamData *)user_data;
+    grn_ctx *context = data->context;
+    char *result = NULL;
+    unsigned int result_size;
+    int flags = 0;
+
+    /* Finish the load command even on error to not keep it in
+     * the context. */
+    rb_grn_table_load_arrow_stream_send(context, "", 0, GRN_CTX_TAIL);
+    grn_ctx_recv(context, &result, &result_size, &flags);
+
+    return Qnil;
+}
+
+/*
+ * @overload load_arrow_stream(input)
+ *
+ *   Loads records from data in Apache Arrow streaming format.
+ *   Unlike {#load_arrow}, it doesn't need a file. Data are read
+ *   and loaded chunk by chunk. So it uses bounded memory for
+ *   large input such as a pipe from other process.
+ *
+ *   The GVL is released while each chunk is loaded if
+ *   {Groonga::Context#release_gvl?} is `true`.
+ *
+ *   @example Load records from standard input.
+ *
+ *     users = Groonga["Users"]
+ *     users.load_arrow_stream($stdin)
+ *
+ *   @param input [String, IO, IO::Buffer] the data in Apache
+ *     Arrow streaming format. `IO` is any object that responds
+ *     to `read(size)`.
+ *
+ *   @return [void]
+ *
+ *   @since 15.0.5
+ */
+static VALUE
+rb_grn_table_load_arrow_stream (VALUE self, VALUE rb_input)
+{
+    grn_ctx *context;
+    grn_obj *table;
+    char name[GRN_TABLE_MAX_KEY_SIZE];
+    int name_size;
+    VALUE rb_command;
+    LoadArrowStreamData data;
+
+    rb_grn_table_deconstruct(SELF(self), &table, &context,
+                             NULL, NULL, NULL,
+                             NULL, NULL,
+                             NULL);
+
+    name_size = grn_obj_name(context, table, name, GRN_TABLE_MAX_KEY_SIZE);
+    if (name_size == 0) {
+        rb_raise(rb_eArgError,
+                 "anonymous table can't be loaded from stream: %" PRIsVALUE,
+                 self);
+    }
+
+    rb_command = rb_str_new_cstr("load --table ");
+    rb_str_cat(rb_command, name, name_size);
+    rb_str_cat_cstr(rb_command, " --input_type apache-arrow");
+    rb_grn_table_load_arrow_stream_send(context,
+                                        RSTRING_PTR(rb_command),
+                                        RSTRING_LEN(rb_command),
+                                        GRN_CTX_MORE);
+    rb_grn_context_check(context, self);
+
+    data.self = self;
+    data.context = context;
+    data.rb_input = rb_input;
+    rb_ensure(rb_grn_table_load_arrow_stream_body, (VALUE)&data,
+              rb_grn_table_load_arrow_stream_ensure, (VALUE)&data);
+    rb_grn_context_check(context, self);
+
+    return self;
+}
+
+typedef struct {
+    grn_ctx *context;
+    grn_obj *table;
+    grn_id table_id;
+    const grn_id *ids;
+    long n_ids;
+    grn_obj *column_names;
+    const char *path;
+    grn_rc rc;
+    char message[GRN_CTX_MSGSIZE];
+} DumpArrowPartition;
+
+static void *
+rb_grn_table_dump_arrow_partition (void *user_data)
+{
+    DumpArrowPartition *partition = user_data;
+    grn_ctx *context = partition->context;
+    grn_obj *table = partition->table;
+    grn_obj *records;
+    grn_obj columns;
+    long i;
+    unsigned int n_columns;
+
+    if (!table) {
+        table = grn_ctx_at(context, partition->table_id);
+    }
+    records = grn_table_create(context, NULL, 0, NULL,
+                               GRN_TABLE_HASH_KEY | GRN_OBJ_WITH_SUBREC,
+                               table, NULL);
+    if (records) {
+        for (i = 0; i < partition->n_ids; i++) {
+            grn_table_add(context, records,
+                          &(partition->ids[i]), sizeof(grn_id),
+                          NULL);
+        }
+
+        GRN_PTR_INIT(&columns, GRN_OBJ_VECTOR, GRN_ID_NIL);
+        n_columns = grn_vector_size(context, partition->column_names);
+        for (i = 0; i < n_columns; i++) {
+            const char *name;
+            unsigned int name_size;
+            grn_obj *column;
+
+            name_size = grn_vector_get_element(context,
+                                               partition->column_names,
+                                               i,
+                                               &name,
+                                               NULL,
+                                               NULL);
+            column = grn_obj_column(context, records, name, name_size);
+            if (column) {
+                GRN_PTR_PUT(context, &columns, column);
+            }
+        }
+        grn_arrow_dump_columns(context, records, &columns, partition->path);
+        n_columns = GRN_BULK_VSIZE(&columns) / sizeof(grn_obj *);
+        for (i = 0; i < n_columns; i++) {
+            grn_obj_unlink(context, GRN_PTR_VALUE_AT(&columns, i));
+        }
+        GRN_OBJ_FIN(context, &columns);
+        grn_obj_close(context, records);
+    }
+
+    partition->rc = context->rc;
+    if (partition->rc != GRN_SUCCESS) {
+        snprintf(partition->message, GRN_CTX_MSGSIZE, "%s", context->errbuf);
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    VALUE self;
+    grn_ctx *context;
+    grn_obj *table;
+    VALUE rb_columns;
+    VALUE rb_column_names;
+    VALUE rb_packed_ids;
+    VALUE rb_paths;
+    RbGrnWorkerPool pool;
+    grn_obj column_names;
+    grn_obj paths;
+    DumpArrowPartition *partitions;
+    long n_partitions;
+} DumpArrowPartitionedData;
+
+static void
+rb_grn_table_dump_arrow_partitioned_add_name (DumpArrowPartitionedData *data,
+                                              VALUE rb_name)
+{
+    if (RB_TYPE_P(rb_name, RUBY_T_SYMBOL)) {
+        rb_name = rb_sym2str(rb_name);
+    }
+    StringValue(rb_name);
+    grn_vector_add_element(data->context, &(data->column_names),
+                           RSTRING_PTR(rb_name),
+                           RSTRING_LEN(rb_name),
+                           0,
+                           GRN_DB_TEXT);
+}
+
+static void
+rb_grn_table_dump_arrow_partitioned_add_column (DumpArrowPartitionedData *data,
+                                                grn_obj *column)
+{
+    char name[GRN_TABLE_MAX_KEY_SIZE];
+    int name_size;
+
+    name_size = grn_column_name(data->context, column,
+                                name, GRN_TABLE_MAX_KEY_SIZE);
+    grn_vector_add_element(data->context, &(data->column_names),
+                           name, name_size, 0, GRN_DB_TEXT);
+}
+
+static void
+rb_grn_table_dump_arrow_partitioned_collect_columns (DumpArrowPartitionedData *data)
+{
+    grn_ctx *context = data->context;
+    long i;
+
+    if (!NIL_P(data->rb_columns)) {
+        VALUE rb_columns = rb_grn_convert_to_array(data->rb_columns);
+        for (i = 0; i < RARRAY_LEN(rb_columns); i++) {
+            grn_obj *column;
+            column = RVAL2GRNOBJECT(RARRAY_AREF(rb_columns, i), &context);
+            rb_grn_table_dump_arrow_partitioned_add_column(data, column);
+        }
+    } else if (!NIL_P(data->rb_column_names)) {
+        VALUE rb_column_names = rb_grn_convert_to_array(data->rb_column_names);
+        for (i = 0; i < RARRAY_LEN(rb_column_names); i++) {
+            rb_grn_table_dump_arrow_partitioned_add_name(
+                data,
+                RARRAY_AREF(rb_column_names, i));
+        }
+    } else {
+        grn_hash *columns;
+
+        columns = grn_hash_create(context,
+                                  NULL,
+                                  sizeof(grn_id),
+                                  0,
+                                  GRN_OBJ_TABLE_HASH_KEY|GRN_HASH_TINY);
+        rb_grn_context_check(context, data->self);
+        grn_table_columns(context, data->table, "", 0, (grn_obj *)columns);
+        GRN_HASH_EACH_BEGIN(context, columns, cursor, id) {
+            void *key;
+            grn_id *column_id;
+            grn_obj *column;
+
+            grn_hash_cursor_get_key(context, cursor, &key);
+            column_id = key;
+            column = grn_ctx_at(context, *column_id);
+            if (!column || grn_obj_is_index_column(context, column)) {
+                continue;
+            }
+            rb_grn_table_dump_arrow_partitioned_add_column(data, column);
+        } GRN_HASH_EACH_END(context, cursor);
+        grn_hash_close(context, columns);
+        rb_grn_context_check(context, data->self);
+    }
+}
+
+static VALUE
+rb_grn_table_dump_arrow_partitioned_body (VALUE user_data)
+{
+    DumpArrowPartitionedData *data = (DumpArrowPartitionedData *)user_data;
+    const grn_id *ids;
+    long i, n_ids, offset;
+
+    rb_grn_table_dump_arrow_partitioned_collect_columns(data);
+
+    for (i = 0; i < data->n_partitions; i++) {
+        VALUE rb_path = RARRAY_AREF(data->rb_paths, i);
+        const char *path = StringValueCStr(rb_path);
+        /* Include the terminating NUL to use it as a C string. */
+        grn_vector_add_element(data->context, &(data->paths),
+                               path,
+                               RSTRING_LEN(rb_path) + 1,
+                               0,
+                               GRN_DB_TEXT);
+    }
+
+    ids = (const grn_id *)RSTRING_PTR(data->rb_packed_ids);
+    n_ids = RSTRING_LEN(data->rb_packed_ids) / sizeof(grn_id);
+    offset = 0;
+    for (i = 0; i < data->n_partitions; i++) {
+        DumpArrowPartition *partition = &(data->partitions[i]);
+        long n_partition_ids;
+
+        n_partition_ids = n_ids / data->n_partitions;
+        if (i < n_ids % data->n_partitions) {
+            n_partition_ids++;
+        }
+        partition->ids = ids + offset;
+        partition->n_ids = n_partition_ids;
+        partition->column_names = &(data->column_names);
+        grn_vector_get_element(data->context, &(data->paths), i,
+                               &(partition->path), NULL, NULL);
+        partition->rc = GRN_SUCCESS;
+        offset += n_partition_ids;
+    }
+
+    if (data->n_partitions == 1) {
+        DumpArrowPartition *partition = &(data->partitions[0]);
+
+        partition->context = data->context;
+        partition->table = data->table;
+        rb_grn_context_call_without_gvl(data->context,
+                                        rb_grn_table_dump_arrow_partition,
+                                        partition);
+    } else {
+        /* Each worker uses its own context. Ruby threads are used
+         * only to wait for workers that run without the GVL. */
+        for (i = 0; i < data->n_partitions; i++) {
+            DumpArrowPartition *partition = &(data->partitions[i]);
+
+            partition->context =
+                rb_grn_worker_pool_get_context(&(data->pool), i);
+            partition->table = NULL;
+            partition->table_id = grn_obj_id(data->context, data->table);
+            rb_grn_worker_pool_spawn(&(data->pool), i,
+                                     rb_grn_table_dump_arrow_partition,
+                                     partition);
+        }
+        rb_grn_worker_pool_join(&(data->pool));
+    }
+
+    for (i = 0; i < data->n_partitions; i++) {
+        DumpArrowPartition *partition = &(data->partitions[i]);
+        if (partition->rc != GRN_SUCCESS) {
+            rb_raise(rb_grn_rc_to_exception(partition->rc),
+                     "failed to dump records to Apache Arrow: "
+                     "%" PRIsVALUE ": %s: %" PRIsVALUE,
+                     RARRAY_AREF(data->rb_paths, i),
+                     partition->message,
+                     data->self);
+        }
+    }
+
+    return Qnil;
+}
+
+static VALUE
+rb_grn_table_dump_arrow_partitioned_ensure (VALUE user_data)
+{
+    DumpArrowPartitionedData *data = (DumpArrowPartitionedData *)user_data;
+
+    rb_grn_worker_pool_fin(&(data->pool));
+    xfree(data->partitions);
+    GRN_OBJ_FIN(data->context, &(data->column_names));
+    GRN_OBJ_FIN(data->context, &(data->paths));
+
+    return Qnil;
+}
+
+static void
+rb_grn_table_dump_arrow_partitioned (VALUE self,
+                                     grn_ctx *context,
+                                     grn_obj *table,
+                                     VALUE rb_path,
+                                     VALUE rb_columns,
+                                     VALUE rb_column_names,
+                                     VALUE rb_offset,
+                                     VALUE rb_limit,
+                                     VALUE rb_condition,
+                                     VALUE rb_n_workers)
+{
+    DumpArrowPartitionedData data;
+    VALUE rb_ids = Qnil;
+    long n_ids;
+    long offset = 0;
+    long limit = -1;
+    long i;
+
+    data.self = self;
+    data.context = context;
+    data.table = table;
+    data.rb_columns = rb_columns;
+    data.rb_column_names = rb_column_names;
+    data.n_partitions = NIL_P(rb_n_workers) ? 1 : NUM2LONG(rb_n_workers);
+    if (data.n_partitions < 1) {
+        rb_raise(rb_eArgError,
+                 ":n_workers must be 1 or larger: %" PRIsVALUE,
+                 rb_n_workers);
+    }
+    if (data.n_partitions > 1 &&
+        !(table->header.flags & GRN_OBJ_PERSISTENT)) {
+        rb_raise(rb_eArgError,
+                 ":n_workers requires a persistent table: %" PRIsVALUE,
+                 self);
+    }
+    if (!NIL_P(rb_offset)) {
+        offset = NUM2LONG(rb_offset);
+        if (offset < 0) {
+            rb_raise(rb_eArgError,
+                     ":offset must be 0 or larger: %" PRIsVALUE,
+                     rb_offset);
+        }
+    }
+    if (!NIL_P(rb_limit)) {
+        limit = NUM2LONG(rb_limit);
+    }
+
+    if (!NIL_P(rb_condition)) {
+        if (RVAL2CBOOL(rb_obj_is_kind_of(rb_condition, rb_cGrnTable))) {
+            rb_ids = rb_condition;
+        } else {
+            rb_ids = rb_funcall(self, rb_intern("select"), 1, rb_condition);
+        }
+    }
+    data.rb_packed_ids = rb_grn_column_collect_ids(context, table, rb_ids, self);
+    n_ids = RSTRING_LEN(data.rb_packed_ids) / sizeof(grn_id);
+    if (offset > n_ids) {
+        offset = n_ids;
+    }
+    if (limit < 0 || offset + limit > n_ids) {
+        limit = n_ids - offset;
+    }
+    data.rb_packed_ids = rb_str_substr(data.rb_packed_ids,
+                                       offset * sizeof(grn_id),
+                                       limit * sizeof(grn_id));
+
+    data.rb_paths = rb_ary_new_capa(data.n_partitions);
+    if (data.n_partitions == 1) {
+        rb_ary_push(data.rb_paths, rb_path);
+    } else {
+        VALUE rb_extension;
+        VALUE rb_base;
+
+        rb_extension = rb_funcall(rb_cFile, rb_intern("extname"), 1, rb_path);
+        rb_base = rb_str_substr(rb_path,
+                                0,
+                                RSTRING_LEN(rb_path) -
+                                RSTRING_LEN(rb_extension));
+        for (i = 0; i < data.n_partitions; i++) {
+            rb_ary_push(data.rb_paths,
+                        rb_sprintf("%" PRIsVALUE "-%ld%" PRIsVALUE,
+                                   rb_base, i, rb_extension));
+        }
+    }
+
+    GRN_TEXT_INIT(&(data.column_names), GRN_OBJ_VECTOR);
+    GRN_TEXT_INIT(&(data.paths), GRN_OBJ_VECTOR);
+    data.partitions = ZALLOC_N(DumpArrowPartition, data.n_partitions);
+    rb_grn_worker_pool_init(&(data.pool),
+                            context,
+                            data.n_partitions > 1 ? data.n_partitions : 0);
+    rb_ensure(rb_grn_table_dump_arrow_partitioned_body, (VALUE)&data,
+              rb_grn_table_dump_arrow_partitioned_ensure, (VALUE)&data);
+}
+
 /*
  * @overload dump_arrow(path, options)
  *
@@ -2831,6 +5596,36 @@ rb_grn_table_load_arrow (VALUE self, VALUE rb_path)
  *     If you don't specify neither `:columns` and `:column_names`,
  *     all columns are dumped. It's the default.
  *
+ *   @option options :offset [Integer] (0) the number of records
+ *     to be skipped. Records are counted in ID order after
+ *     `:condition` is applied.
+ *
+ *     @since 15.0.5
+ *
+ *   @option options :limit [Integer] (-1) the max number of
+ *     records to be dumped. Negative value means all records.
+ *
+ *     @since 15.0.5
+ *
+ *   @option options :condition [Groonga::Expression, String,
+ *     Groonga::Table] (nil) the condition to filter records.
+ *     `Groonga::Expression` and `String` are passed to
+ *     {#select}. `Groonga::Table` is a search result of the
+ *     table.
+ *
+ *     @since 15.0.5
+ *
+ *   @option options :n_workers [Integer] (1) the number of
+ *     workers. If this is 2 or larger, records are split into
+ *     `:n_workers` partitions and each partition is dumped to
+ *     its own file in parallel. Each worker uses its own
+ *     context. Partition `N` is dumped to `BASE-N.EXTENSION`
+ *     for `path` `BASE.EXTENSION`. For example, `users.arrow`
+ *     is split into `users-0.arrow`, `users-1.arrow` and so
+ *     on. The table must be persistent.
+ *
+ *     @since 15.0.5
+ *
  *   @return [void]
  *
  *   @since 7.0.3
@@ -2846,11 +5641,19 @@ rb_grn_table_dump_arrow (int argc, VALUE *argv, VALUE self)
     VALUE rb_options;
     VALUE rb_columns = Qnil;
     VALUE rb_column_names = Qnil;
+    VALUE rb_offset = Qnil;
+    VALUE rb_limit = Qnil;
+    VALUE rb_condition = Qnil;
+    VALUE rb_n_workers = Qnil;
 
     rb_scan_args(argc, argv, "11", &rb_path, &rb_options);
     rb_grn_scan_options(rb_options,
                         "columns", &rb_columns,
                         "column_names", &rb_column_names,
+                        "offset", &rb_offset,
+                        "limit", &rb_limit,
+                        "condition", &rb_condition,
+                        "n_workers", &rb_n_workers,
                         NULL);
 
     rb_grn_table_deconstruct(SELF(self), &table, &context,
@@ -2873,6 +5676,23 @@ rb_grn_table_dump_arrow (int argc, VALUE *argv, VALUE self)
     }
     path = StringValueCStr(rb_path);
 
+    if (!(NIL_P(rb_offset) &&
+          NIL_P(rb_limit) &&
+          NIL_P(rb_condition) &&
+          NIL_P(rb_n_workers))) {
+        rb_grn_table_dump_arrow_partitioned(self,
+                                            context,
+                                            table,
+                                            rb_path,
+                                            rb_columns,
+                                            rb_column_names,
+                                            rb_offset,
+                                            rb_limit,
+                                            rb_condition,
+                                            rb_n_workers);
+        return self;
+    }
+
     if (NIL_P(rb_columns) && NIL_P(rb_column_names)) {
         rc = grn_arrow_dump(context, table, path);
     } else if (!NIL_P(rb_columns)) {
@@ -2956,6 +5776,8 @@ rb_grn_init_table (VALUE mGrn)
                      rb_grn_table_get_columns, -1);
     rb_define_method(rb_cGrnTable, "have_column?",
                      rb_grn_table_have_column, 1);
+    rb_define_method(rb_cGrnTable, "column_arrays",
+                     rb_grn_table_get_column_arrays, -1);
 
     rb_define_method(rb_cGrnTable, "open_cursor", rb_grn_table_open_cursor, -1);
     rb_define_method(rb_cGrnTable, "records", rb_grn_table_get_records, -1);
@@ -2965,6 +5787,7 @@ rb_grn_init_table (VALUE mGrn)
     rb_define_method(rb_cGrnTable, "truncate", rb_grn_table_truncate, 0);
 
     rb_define_method(rb_cGrnTable, "each", rb_grn_table_each, -1);
+    rb_define_method(rb_cGrnTable, "each_row", rb_grn_table_each_row, -1);
 
     rb_define_method(rb_cGrnTable, "each_sub_record",
                      rb_grn_table_each_sub_record, 1);
@@ -2974,6 +5797,8 @@ rb_grn_init_table (VALUE mGrn)
     rb_define_method(rb_cGrnTable, "sort", rb_grn_table_sort, -1);
     rb_define_method(rb_cGrnTable, "geo_sort", rb_grn_table_geo_sort, -1);
     rb_define_method(rb_cGrnTable, "group", rb_grn_table_group, -1);
+    rb_define_private_method(rb_cGrnTable, "aggregate_native",
+                             rb_grn_table_aggregate_native, 3);
 
     rb_define_method(rb_cGrnTable, "[]", rb_grn_table_array_reference, 1);
     rb_undef_method(rb_cGrnTable, "[]=");
@@ -3019,7 +5844,12 @@ rb_grn_init_table (VALUE mGrn)
 
     rb_define_method(rb_cGrnTable, "rename", rb_grn_table_rename, 1);
 
+    rb_define_method(rb_cGrnTable, "load_rows", rb_grn_table_load_rows, -1);
+    rb_define_method(rb_cGrnTable, "load_records",
+                     rb_grn_table_load_records, -1);
     rb_define_method(rb_cGrnTable, "load_arrow", rb_grn_table_load_arrow, 1);
+    rb_define_method(rb_cGrnTable, "load_arrow_stream",
+                     rb_grn_table_load_arrow_stream, 1);
     rb_define_method(rb_cGrnTable, "dump_arrow", rb_grn_table_dump_arrow, -1);
 
     rb_grn_init_table_key_support(mGrn);
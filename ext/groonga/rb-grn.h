@@ -27,6 +27,18 @@
 #  include <ruby/intern.h>
 #endif
 
+#ifdef HAVE_RUBY_THREAD_H
+#  include <ruby/thread.h>
+#endif
+
+#ifdef HAVE_RUBY_THREAD_NATIVE_H
+#  include <ruby/thread_native.h>
+#endif
+
+#ifdef HAVE_RUBY_IO_BUFFER_H
+#  include <ruby/io/buffer.h>
+#endif
+
 #ifndef RETURN_ENUMERATOR
 #  define RETURN_ENUMERATOR(obj, argc, argv)
 #endif
@@ -91,6 +103,24 @@ RB_GRN_BEGIN_DECLS
 
 #define RB_GRN_HAVE_FLOAT32 GRN_VERSION_OR_LATER(10, 0, 2)
 
+#if defined(RB_THREAD_LOCAL_SPECIFIER)
+#  define RB_GRN_THREAD_LOCAL RB_THREAD_LOCAL_SPECIFIER
+#elif defined(__GNUC__)
+#  define RB_GRN_THREAD_LOCAL __thread
+#endif
+
+#if defined(HAVE_RB_THREAD_CALL_WITHOUT_GVL2) && defined(RB_GRN_THREAD_LOCAL)
+#  define RB_GRN_SUPPORT_WITHOUT_GVL 1
+#else
+#  define RB_GRN_SUPPORT_WITHOUT_GVL 0
+#endif
+
+#if defined(HAVE_RUBY_IO_BUFFER_H) && defined(HAVE_RB_IO_BUFFER_NEW)
+#  define RB_GRN_SUPPORT_IO_BUFFER 1
+#else
+#  define RB_GRN_SUPPORT_IO_BUFFER 0
+#endif
+
 #define RB_GRN_MAJOR_VERSION 15
 #define RB_GRN_MINOR_VERSION 0
 #define RB_GRN_MICRO_VERSION 5
@@ -117,6 +147,10 @@ struct _RbGrnContext
     grn_ctx *context;
     grn_ctx context_entity;
     grn_hash *floating_objects;
+    grn_bool release_gvl;
+    grn_bool connected;
+    grn_bool detached;
+    grn_bool database_shared;
     VALUE self;
 };
 
@@ -254,6 +288,23 @@ struct _RbGrnColumnCache
     grn_obj *table;
 };
 
+typedef struct _RbGrnWorker RbGrnWorker;
+struct _RbGrnWorker
+{
+    grn_ctx context;
+    void *(*function)(void *data);
+    void *data;
+};
+
+typedef struct _RbGrnWorkerPool RbGrnWorkerPool;
+struct _RbGrnWorkerPool
+{
+    grn_ctx *context;
+    RbGrnWorker *workers;
+    long n_workers;
+    VALUE rb_threads;
+};
+
 RB_GRN_VAR grn_bool rb_grn_exited;
 
 RB_GRN_VAR VALUE rb_eGrnError;
@@ -379,6 +430,7 @@ void           rb_grn_init_id                       (VALUE mGrn);
 void           rb_grn_init_name                     (VALUE mGrn);
 void           rb_grn_init_default_cache            (VALUE mGrn);
 void           rb_grn_init_column_cache             (VALUE mGrn);
+void           rb_grn_init_table_dumper             (VALUE mGrn);
 
 VALUE          rb_grn_rc_to_exception               (grn_rc rc);
 void           rb_grn_rc_check                      (grn_rc rc,
@@ -404,6 +456,26 @@ grn_obj       *rb_grn_context_get_backward_compatibility
                                                      unsigned int name_size);
 void           rb_grn_context_object_created        (VALUE rb_context,
                                                      VALUE rb_object);
+void          *rb_grn_context_call_without_gvl      (grn_ctx *context,
+                                                     void *(*function)(void *data),
+                                                     void *data);
+void          *rb_grn_call_without_gvl              (grn_ctx *context,
+                                                     void *(*function)(void *data),
+                                                     void *data);
+void          *rb_grn_context_call_with_gvl         (void *(*function)(void *data),
+                                                     void *data);
+void           rb_grn_worker_pool_init              (RbGrnWorkerPool *pool,
+                                                     grn_ctx *context,
+                                                     long n_workers);
+grn_ctx       *rb_grn_worker_pool_get_context       (RbGrnWorkerPool *pool,
+                                                     long i);
+void           rb_grn_worker_pool_spawn             (RbGrnWorkerPool *pool,
+                                                     long i,
+                                                     void *(*function)(void *data),
+                                                     void *data);
+void           rb_grn_worker_pool_join              (RbGrnWorkerPool *pool);
+void           rb_grn_worker_pool_stop              (RbGrnWorkerPool *pool);
+void           rb_grn_worker_pool_fin               (RbGrnWorkerPool *pool);
 
 const char    *rb_grn_inspect                       (VALUE object);
 void           rb_grn_scan_options                  (VALUE options, ...)
@@ -585,6 +657,14 @@ void           rb_grn_column_deconstruct            (RbGrnColumn *rb_grn_column,
                                                      grn_obj **value,
                                                      grn_id *range_id,
                                                      grn_obj **range);
+VALUE          rb_grn_column_collect_ids            (grn_ctx *context,
+                                                     grn_obj *table,
+                                                     VALUE rb_ids,
+                                                     VALUE related_object);
+VALUE          rb_grn_column_values_at              (grn_ctx *context,
+                                                     grn_obj *column,
+                                                     VALUE rb_ids,
+                                                     VALUE related_object);
 
 void           rb_grn_variable_size_column_bind     (RbGrnVariableSizeColumn *rb_grn_column,
                                                      grn_ctx *context,
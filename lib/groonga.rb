@@ -1,4 +1,4 @@
-# Copyright (C) 2009-2020  Sutou Kouhei <kou@clear-code.com>
+# Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -88,10 +88,26 @@ module Groonga
     def [](name)
       Context.default[name]
     end
+
+    # Re-creates the default context in a child process after
+    # `fork`. It does nothing if the default context isn't created
+    # yet.
+    #
+    # @return [void]
+    #
+    # @see Groonga::Context#reopen_after_fork
+    #
+    # @since 15.0.5
+    def after_fork
+      context = Context.class_variable_get(:@@default)
+      return if context.nil?
+      context.reopen_after_fork
+    end
   end
 end
 
 require "groonga/context"
+require "groonga/expression-cache"
 require "groonga/database"
 require "groonga/column"
 require "groonga/patricia-trie"
@@ -100,6 +116,9 @@ require "groonga/dumper"
 require "groonga/database-inspector"
 require "groonga/schema"
 require "groonga/pagination"
+require "groonga/aggregate-result"
+require "groonga/prepared-select"
+require "groonga/search-pool"
 require "groonga/grntest-log"
 require "groonga/logger"
 require "groonga/query-logger"
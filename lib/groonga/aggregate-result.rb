@@ -0,0 +1,200 @@
+# Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # A columnar result of {Groonga::Table#aggregate}. Each column is
+  # an Array that has a value for each group. The same index in
+  # columns refers the same group.
+  #
+  # @since 15.0.5
+  class AggregateResult
+    include Enumerable
+
+    # The available aggregate types.
+    TYPES = [:count, :sum, :min, :max, :average]
+
+    # @return [::Array<String>] The names of the group keys.
+    attr_reader :key_names
+
+    # @return [::Array<Integer>] The number of records in each group.
+    attr_reader :n_records
+
+    # @api private
+    def initialize(key_names, key_values, n_records, aggregates)
+      @key_names = key_names
+      @key_values = key_values
+      @n_records = n_records
+      @aggregates = aggregates
+    end
+
+    # @return [Integer] The number of groups.
+    def size
+      @n_records.size
+    end
+
+    # @overload [](key_name)
+    #   @param key_name [String, Symbol] The name of a group key.
+    #   @return [::Array] The key values of groups.
+    #
+    # @overload [](target_name, type)
+    #   @param target_name [String, Symbol] The name of an aggregated
+    #     column.
+    #   @param type [Symbol] One of {TYPES}.
+    #   @return [::Array<Numeric, nil>] The aggregated values of
+    #     groups. `:sum`, `:min`, `:max` and `:average` values are
+    #     Float. `:min`, `:max` and `:average` are `nil` for a group
+    #     that has no value.
+    def [](name, type=nil)
+      name = name.to_s
+      if type.nil?
+        index = @key_names.index(name)
+        raise ArgumentError, "unknown key: <#{name}>" if index.nil?
+        @key_values[index]
+      else
+        values = (@aggregates[name] || {})[type.to_sym]
+        if values.nil?
+          raise ArgumentError,
+                "not aggregated: <#{name}>: <#{type.inspect}>"
+        end
+        values
+      end
+    end
+
+    # @return [::Array<String>] The names of the aggregated columns.
+    def target_names
+      @aggregates.keys
+    end
+
+    # Iterates groups as rows.
+    #
+    # @yield [row] Gives a row for each group.
+    # @yieldparam row [::Hash{String => Object}] The key values, the
+    #   number of records as `"n_records"` and the aggregated values
+    #   as `"#{target_name}.#{type}"` such as `"price.sum"`.
+    # @return [void]
+    def each
+      return to_enum(__method__) unless block_given?
+      size.times do |i|
+        row = {}
+        @key_names.each_with_index do |key_name, j|
+          row[key_name] = @key_values[j][i]
+        end
+        row["n_records"] = @n_records[i]
+        @aggregates.each do |target_name, values_by_type|
+          values_by_type.each do |type, values|
+            row["#{target_name}.#{type}"] = values[i]
+          end
+        end
+        yield(row)
+      end
+    end
+  end
+
+  class Table
+    # Groups records by `keys` and computes aggregated values of
+    # multiple columns in one pass.
+    #
+    # {#group} can compute only one target column and you need to read
+    # the result record by record. This reads each record only once
+    # for all targets and returns a columnar result.
+    #
+    # @example Sum and average prices and count items by category.
+    #   result = items.aggregate("category",
+    #                            :aggregates => {
+    #                              "price" => [:sum, :average],
+    #                              "stock" => [:max],
+    #                            })
+    #   result["category"]        # => ["Book", "Food"]
+    #   result.n_records          # => [3, 2]
+    #   result["price", :average] # => [1200.0, 300.0]
+    #
+    # @param keys [String, Symbol, Groonga::Column, ::Array] The group
+    #   keys. Vector columns can't be used.
+    # @param options [::Hash] The name and value
+    #   pairs. Omitted names are initialized as the default value.
+    # @option options [::Hash{String => ::Array<Symbol>}] :aggregates
+    #   The target column names and their aggregate types. Available
+    #   types are `:count`, `:sum`, `:min`, `:max` and `:average`
+    #   (`:avg` is an alias). `:count` is the number of non empty
+    #   values. Values are cast to Float.
+    # @option options [Integer] :n_workers (1) The number of workers.
+    #   If it's 2 or larger, records are split into `:n_workers`
+    #   partitions and each worker groups its partition into its own
+    #   hash table without the GVL. Hash tables are merged at the
+    #   end. It's used only for a persistent table or a result of
+    #   {#select} of a persistent table and only when pseudo columns
+    #   such as `_key` aren't used. Otherwise one worker is used.
+    # @return [Groonga::AggregateResult] The columnar result.
+    #
+    # @since 15.0.5
+    def aggregate(keys, options={})
+      keys = [keys] unless keys.is_a?(::Array)
+      key_names = keys.collect do |key|
+        normalize_aggregate_column_name(key)
+      end
+      types_by_target = {}
+      (options[:aggregates] || {}).each do |target, types|
+        types = [types] unless types.is_a?(::Array)
+        types = types.collect do |type|
+          type = type.to_sym
+          type = :average if type == :avg
+          unless AggregateResult::TYPES.include?(type)
+            raise ArgumentError,
+                  "invalid aggregate type: #{type.inspect}: " +
+                  "available types: #{AggregateResult::TYPES.inspect}"
+          end
+          type
+        end
+        types_by_target[normalize_aggregate_column_name(target)] = types
+      end
+      target_names = types_by_target.keys
+
+      key_values, n_records, target_values =
+        aggregate_native(key_names, target_names, options[:n_workers])
+      aggregates = {}
+      target_names.each_with_index do |target_name, i|
+        sums, mins, maxs, n_values = target_values[i]
+        values_by_type = {}
+        types_by_target[target_name].each do |type|
+          case type
+          when :count
+            values_by_type[type] = n_values
+          when :sum
+            values_by_type[type] = sums
+          when :min
+            values_by_type[type] = mins
+          when :max
+            values_by_type[type] = maxs
+          when :average
+            values_by_type[type] = sums.zip(n_values).collect do |sum, n|
+              n.zero? ? nil : sum / n
+            end
+          end
+        end
+        aggregates[target_name] = values_by_type
+      end
+      AggregateResult.new(key_names, key_values, n_records, aggregates)
+    end
+
+    private
+    def normalize_aggregate_column_name(column)
+      if column.is_a?(Column) or column.is_a?(Accessor)
+        column.local_name
+      else
+        column.to_s
+      end
+    end
+  end
+end
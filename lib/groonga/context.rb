@@ -13,8 +13,11 @@
 # License along with this library; if not, write to the Free Software
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
+require "json"
+
 require "groonga/memory-pool"
 require "groonga/context/command-executor"
+require "groonga/context/pipeline"
 
 module Groonga
   class Context
@@ -50,6 +53,14 @@ module Groonga
       end
     end
 
+    # @return [Groonga::ExpressionCache, nil] The cache of
+    #   expressions for {Groonga::Table#select} with a query string.
+    #   It's `nil` by default. Expressions aren't cached when it's
+    #   `nil`.
+    #
+    # @since 15.0.5
+    attr_accessor :expression_cache
+
     # _path_ にある既存のデータベースを開く。ブロックを指定した場
     # 合はブロックに開いたデータベースを渡し、ブロックを抜けると
     # きに閉じる。
@@ -201,6 +212,86 @@ module Groonga
       executor.execute(name, parameters)
     end
 
+    # Sends commands without waiting for each response. It's useful
+    # to reduce round trips to a groonga server connected by
+    # {#connect}.
+    #
+    # @example Send some commands and receive their responses at once
+    #   context.connect(:host => "127.0.0.1", :port => 10041)
+    #   responses = context.pipeline do |pipeline|
+    #     pipeline.execute("status")
+    #     pipeline.execute("select", :table => "Users")
+    #   end
+    #   status_response, select_response = responses
+    #
+    # @overload pipeline
+    #   @return [Groonga::Context::Pipeline] A new pipeline. You need
+    #     to call {Groonga::Context::Pipeline#wait} or
+    #     {Groonga::Context::Pipeline#receive} to receive responses.
+    #
+    # @overload pipeline {|pipeline| ...}
+    #   @yieldparam pipeline [Groonga::Context::Pipeline] A new pipeline.
+    #   @return [::Array<Groonga::Client::Response::Base>] Responses
+    #     of the commands executed in the block in the same order.
+    #     All responses are received before this method returns.
+    #
+    # @since 15.0.5
+    def pipeline
+      pipeline = Pipeline.new(self)
+      return pipeline unless block_given?
+
+      begin
+        yield(pipeline)
+      ensure
+        pipeline.wait
+      end
+      pipeline.requests.collect(&:response)
+    end
+
+    # Re-creates the context in a child process after `fork`. Call
+    # this in the child process before using the context. The `grn_ctx`
+    # inherited from the parent process is left untouched. It isn't
+    # closed or freed, so its pages stay shared with the parent
+    # process by copy-on-write.
+    #
+    # A new `grn_ctx` is created with the same encoding and the same
+    # `release_gvl` value. The database is opened again by its path.
+    # The files of the database are mmap-ed again, so the child
+    # process shares the page cache with the parent process. Tables
+    # and columns are opened lazily when they are accessed. A
+    # connection to a groonga server is created again.
+    #
+    # Objects such as tables and columns that were retrieved before
+    # `fork` still refer to the inherited `grn_ctx`. Retrieve them
+    # again by {#[]}.
+    #
+    # @example Reopen the default context in a Puma worker
+    #   on_worker_boot do
+    #     Groonga.after_fork
+    #   end
+    #
+    # @return [void]
+    #
+    # @see Groonga.after_fork
+    #
+    # @since 15.0.5
+    def reopen_after_fork
+      return if closed?
+
+      current_database = database
+      database_path = current_database ? current_database.path : nil
+      connected = connected?
+      connect_options = @connect_options
+      new_encoding = encoding
+      new_release_gvl = release_gvl?
+
+      detach_after_fork
+      initialize(encoding: new_encoding, release_gvl: new_release_gvl)
+      @expression_cache.clear if @expression_cache
+      open_database(database_path) if database_path
+      connect(connect_options || {}) if connected
+    end
+
     # Restore commands dumped by "grndump" command.
     #
     # @example Restore dumped commands as a String object.
@@ -257,6 +348,63 @@ module Groonga
       end
     end
 
+    # Restore a directory dumped by {Groonga::DatabaseDumper#dump}
+    # with `:directory` option.
+    #
+    # The schema is restored first. Then records of tables are
+    # restored concurrently by `n_workers` threads. Index columns are
+    # created after all records are loaded. It's faster than updating
+    # index columns on each load.
+    #
+    # Each worker uses its own context that shares the database of
+    # this context and releases the GVL while loading.
+    #
+    # @example Restore a dumped directory with 4 workers.
+    #   Groonga::DatabaseDumper.dump(:directory => "dump", :n_workers => 4)
+    #   context.create_database("restored.db") do
+    #     context.restore_directory("dump", :n_workers => 4)
+    #   end
+    #
+    # @param directory [String] The directory dumped by
+    #   {Groonga::DatabaseDumper#dump}.
+    # @param options [::Hash] The options.
+    # @option options :n_workers [Integer] (1) The number of threads
+    #   that load records.
+    # @yield [command, response]
+    #   Yields a sent command and its response if block is given. It
+    #   may be called from worker threads but it's never called
+    #   concurrently.
+    # @yieldparam command [String] A sent command.
+    # @yieldparam response [String] A response for a command.
+    # @return [void]
+    #
+    # @since 15.0.5
+    def restore_directory(directory, options={}, &block)
+      directory = directory.to_s
+      manifest_path = File.join(directory, DatabaseDumper::MANIFEST_FILE_NAME)
+      manifest = JSON.parse(File.read(manifest_path))
+
+      if manifest["schema"]
+        restore_file(File.join(directory, manifest["schema"]), &block)
+      end
+
+      table_paths = manifest["tables"].collect do |path|
+        File.join(directory, path)
+      end
+      n_workers = options[:n_workers] || 1
+      if n_workers <= 1 or table_paths.size <= 1
+        table_paths.each do |path|
+          restore_file(path, &block)
+        end
+      else
+        restore_files_parallel(table_paths, n_workers, &block)
+      end
+
+      if manifest["indexes"]
+        restore_file(File.join(directory, manifest["indexes"]), &block)
+      end
+    end
+
     # Pushes a new memory pool to the context. Temporary objects that
     # are created between pushing a new memory pool and popping the
     # new memory pool are closed automatically when popping the new
@@ -393,5 +541,50 @@ module Groonga
     def config
       @config ||= Config.new(self)
     end
+
+    private
+    def restore_file(path, &block)
+      File.open(path, "r:utf-8") do |file|
+        restore(file, &block)
+      end
+    end
+
+    def restore_files_parallel(paths, n_workers, &block)
+      shared_database = database
+      queue = Thread::Queue.new
+      paths.each do |path|
+        queue << path
+      end
+      queue.close
+      mutex = Thread::Mutex.new
+      if block
+        synchronized_block = lambda do |command, response|
+          mutex.synchronize do
+            block.call(command, response)
+          end
+        end
+      end
+      workers = [n_workers, paths.size].min.times.collect do
+        Thread.new do
+          Thread.current.report_on_exception = false
+          self.class.open(encoding: encoding,
+                          release_gvl: true) do |context|
+            context.__send__(:use_database_native, shared_database)
+            while (path = queue.pop)
+              context.__send__(:restore_file, path, &synchronized_block)
+            end
+          end
+        end
+      end
+      errors = []
+      workers.each do |worker|
+        begin
+          worker.join
+        rescue => error
+          errors << error
+        end
+      end
+      raise errors.first unless errors.empty?
+    end
   end
 end
@@ -26,29 +26,39 @@ module Groonga
       end
 
       def execute(name, parameters={})
-        parameters = normalize_parameters(name, parameters)
-        command_class = Command.find(name)
-        command = command_class.new(name, parameters)
+        command = create_command(name, parameters)
         request_id = @context.send(command.to_command_format)
         loop do
           response_id, raw_response = @context.receive
           if request_id == response_id
-            response_class = Client::Response.find(command.name)
-            header = [0, 0, 0]
-            case command.output_type
-            when :json
-              body = JSON.parse(raw_response)
-            else
-              body = raw_response
-            end
-            response = response_class.new(command, header, body)
-            response.raw = raw_response
-            return response
+            return create_response(command, raw_response)
           end
           # raise if request_id < response_id
         end
       end
 
+      # @api private
+      def create_command(name, parameters)
+        parameters = normalize_parameters(name, parameters)
+        command_class = Command.find(name)
+        command_class.new(name, parameters)
+      end
+
+      # @api private
+      def create_response(command, raw_response)
+        response_class = Client::Response.find(command.name)
+        header = [0, 0, 0]
+        case command.output_type
+        when :json
+          body = JSON.parse(raw_response)
+        else
+          body = raw_response
+        end
+        response = response_class.new(command, header, body)
+        response.raw = raw_response
+        response
+      end
+
       private
       def normalize_parameters(name, parameters)
         case name
@@ -0,0 +1,112 @@
+# Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "groonga/context/command-executor"
+
+module Groonga
+  class Context
+    # Sends commands without waiting for their responses.
+    #
+    # A groonga server processes commands sent through a connection
+    # in order. So responses are received in the same order as the
+    # requests and they are matched with requests in the order.
+    #
+    # Commands are executed one by one when the context isn't
+    # connected to a groonga server because a local context can't
+    # have more than one command in flight.
+    #
+    # @see Groonga::Context#pipeline
+    #
+    # @since 15.0.5
+    class Pipeline
+      # A command sent by {Pipeline#execute}.
+      class Request
+        # @return [Groonga::Command::Base] The sent command.
+        attr_reader :command
+        # @return [Integer] The ID returned by {Groonga::Context#send}.
+        attr_reader :id
+        # @return [Groonga::Client::Response::Base, nil] The response
+        #   of the command. It's `nil` until the response is received.
+        attr_accessor :response
+        def initialize(command, id)
+          @command = command
+          @id = id
+          @response = nil
+        end
+
+        # @return [Boolean] `true` if the response is received,
+        #   `false` otherwise.
+        def received?
+          not @response.nil?
+        end
+      end
+
+      # @return [::Array<Request>] All requests sent by {#execute}.
+      attr_reader :requests
+      def initialize(context)
+        @context = context
+        @executor = CommandExecutor.new(@context)
+        @requests = []
+        @pending_requests = []
+      end
+
+      # Sends a command. It doesn't wait for the response.
+      #
+      # @param name [String] The command name.
+      # @param parameters [::Hash] The command parameters.
+      # @return [Request] The sent request.
+      def execute(name, parameters={})
+        command = @executor.create_command(name, parameters)
+        id = @context.send(command.to_command_format)
+        request = Request.new(command, id)
+        @requests << request
+        @pending_requests << request
+        receive unless @context.connected?
+        request
+      end
+
+      # @return [Integer] The number of requests that their responses
+      #   aren't received yet.
+      def n_pending_requests
+        @pending_requests.size
+      end
+
+      # Receives the response of the oldest pending request.
+      #
+      # @return [Request, nil] The request that its response is
+      #   received. `nil` if there is no pending request.
+      def receive
+        request = @pending_requests.shift
+        return nil if request.nil?
+        id, raw_response = @context.receive
+        if id != request.id
+          raise Error,
+                "response ID doesn't match request ID: " +
+                "expected: <#{request.id}>: actual: <#{id}>"
+        end
+        request.response = @executor.create_response(request.command,
+                                                     raw_response)
+        request
+      end
+
+      # Receives responses of all pending requests.
+      #
+      # @return [void]
+      def wait
+        receive until @pending_requests.empty?
+      end
+    end
+  end
+end
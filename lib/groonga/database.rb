@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2012-2013  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2012-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -15,6 +15,10 @@
 # License along with this library; if not, write to the Free Software
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
+require "etc"
+
+require "groonga/database/reindex-progress"
+
 module Groonga
   class Database
     # @return [Array<Groonga::Table>] tables defined in the database.
@@ -44,11 +48,107 @@ module Groonga
       paths
     end
 
+    # Recreates index columns concurrently. Each worker thread uses
+    # its own Groonga context that shares this database and releases
+    # the GVL. Index columns that share the same lexicon are recreated
+    # by the same worker because they update the same lexicon.
+    #
+    # @example Recreate all index columns with progress
+    #   database.reindex_parallel(:n_workers => 4) do |progress|
+    #     puts("#{progress.n_done_indexes}/#{progress.n_indexes}: " +
+    #          "ETA: #{progress.eta.round}s")
+    #   end
+    #
+    # @param options [::Hash] The options.
+    # @option options :indexes [::Array<Groonga::IndexColumn, String>]
+    #   (all index columns) The target index columns.
+    # @option options :n_workers [Integer] (the number of processors)
+    #   The max number of worker threads.
+    # @option options :progress [Groonga::Database::ReindexProgress]
+    #   The progress object to be updated. You can poll it from
+    #   another thread.
+    # @yield [progress] Each time an index column is recreated. The
+    #   block isn't called concurrently.
+    # @yieldparam progress [Groonga::Database::ReindexProgress] The
+    #   current progress.
+    # @return [Groonga::Database::ReindexProgress] The progress.
+    #
+    # @see Groonga::IndexColumn#reindex
+    #
+    # @since 15.0.5
+    def reindex_parallel(options={}, &block)
+      progress = options[:progress] || ReindexProgress.new
+      index_groups = {}
+      each_reindex_target(options[:indexes]) do |index|
+        lexicon_id = index.table.id
+        index_groups[lexicon_id] ||= []
+        index_groups[lexicon_id] << [index.id, index.name]
+        progress.add(index.name, index.range.size)
+      end
+
+      queue = Thread::Queue.new
+      index_groups.each_value do |indexes|
+        queue << indexes
+      end
+      queue.close
+      mutex = Thread::Mutex.new
+      n_workers = options[:n_workers] || Etc.nprocessors
+      progress.start
+      workers = [n_workers, index_groups.size].min.times.collect do
+        Thread.new do
+          Thread.current.report_on_exception = false
+          while (indexes = queue.pop)
+            indexes.each do |index_id, index_name|
+              progress.start_index(index_name)
+              reindex_index_native(index_id)
+              # Finishing and reporting must be atomic. Otherwise
+              # the block may see the same progress twice.
+              mutex.synchronize do
+                progress.finish_index(index_name)
+                block.call(progress) if block
+              end
+            end
+          end
+        end
+      end
+      errors = []
+      workers.each do |worker|
+        begin
+          worker.join
+        rescue => error
+          errors << error
+        end
+      end
+      raise errors.first unless errors.empty?
+      progress
+    end
+
     def dump_index(output_directory)
       each do |object|
         next unless object.is_a?(Groonga::IndexColumn)
         object.dump(output_directory)
       end
     end
+
+    private
+    def each_reindex_target(indexes)
+      if indexes.nil?
+        each(:ignore_missing_object => true, :order_by => :key) do |object|
+          yield(object) if object.is_a?(Groonga::IndexColumn)
+        end
+      else
+        indexes.each do |index|
+          unless index.is_a?(Groonga::IndexColumn)
+            index_name = index
+            index = context[index_name]
+            unless index.is_a?(Groonga::IndexColumn)
+              raise ArgumentError,
+                    "must be an index column: <#{index_name.inspect}>"
+            end
+          end
+          yield(index)
+        end
+      end
+    end
   end
 end
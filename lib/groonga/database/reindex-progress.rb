@@ -0,0 +1,137 @@
+# Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  class Database
+    # The progress of {Groonga::Database#reindex_parallel}. It's
+    # thread-safe. You can poll it from another thread while index
+    # columns are recreated.
+    #
+    # Progress is estimated by the number of records in the source
+    # tables of index columns.
+    #
+    # @since 15.0.5
+    class ReindexProgress
+      # @return [::Array<String>] The names of all target index columns.
+      attr_reader :index_names
+      def initialize
+        @mutex = Thread::Mutex.new
+        @index_names = []
+        @weights = {}
+        @total_weight = 0
+        @done_weight = 0
+        @done_index_names = []
+        @running_index_names = []
+        @start_time = nil
+      end
+
+      # @api private
+      def add(index_name, weight)
+        @mutex.synchronize do
+          weight = 1 if weight < 1
+          @index_names << index_name
+          @weights[index_name] = weight
+          @total_weight += weight
+        end
+      end
+
+      # @api private
+      def start
+        @mutex.synchronize do
+          @start_time = now
+        end
+      end
+
+      # @api private
+      def start_index(index_name)
+        @mutex.synchronize do
+          @running_index_names << index_name
+        end
+      end
+
+      # @api private
+      def finish_index(index_name)
+        @mutex.synchronize do
+          @running_index_names.delete(index_name)
+          @done_index_names << index_name
+          @done_weight += @weights[index_name]
+        end
+      end
+
+      # @return [Integer] The number of target index columns.
+      def n_indexes
+        @index_names.size
+      end
+
+      # @return [Integer] The number of recreated index columns.
+      def n_done_indexes
+        @mutex.synchronize do
+          @done_index_names.size
+        end
+      end
+
+      # @return [::Array<String>] The names of recreated index columns.
+      def done_index_names
+        @mutex.synchronize do
+          @done_index_names.dup
+        end
+      end
+
+      # @return [::Array<String>] The names of index columns that are
+      #   being recreated.
+      def running_index_names
+        @mutex.synchronize do
+          @running_index_names.dup
+        end
+      end
+
+      # @return [Boolean] `true` if all index columns are recreated,
+      #   `false` otherwise.
+      def done?
+        n_done_indexes == n_indexes
+      end
+
+      # @return [Float] The ratio of the progress. It's between `0.0`
+      #   and `1.0`.
+      def ratio
+        @mutex.synchronize do
+          return 1.0 if @total_weight.zero?
+          @done_weight.to_f / @total_weight
+        end
+      end
+
+      # @return [Float] The elapsed time in seconds.
+      def elapsed_time
+        @mutex.synchronize do
+          return 0.0 if @start_time.nil?
+          now - @start_time
+        end
+      end
+
+      # @return [Float, nil] The estimated rest time in seconds. `nil`
+      #   if no index column is recreated yet.
+      def eta
+        current_ratio = ratio
+        return nil if current_ratio.zero?
+        elapsed_time * (1.0 - current_ratio) / current_ratio
+      end
+
+      private
+      def now
+        Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      end
+    end
+  end
+end
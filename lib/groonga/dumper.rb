@@ -14,6 +14,8 @@
 # License along with this library; if not, write to the Free Software
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
+require 'fileutils'
+require 'json'
 require 'stringio'
 
 module Groonga
@@ -40,22 +42,43 @@ module Groonga
       end
     end
 
+    # The name of the file that lists dumped files in a directory
+    # dump. See {#dump}.
+    MANIFEST_FILE_NAME = "manifest.json"
+
     def initialize(options={})
       @options = options
     end
 
+    # Dumps the database.
+    #
+    # If `:directory` option is specified, the database is dumped to
+    # the directory instead of `:output`. The directory has the
+    # following files:
+    #
+    #   * `schema.grn`: Plugins, tables and reference columns.
+    #   * `tables/TABLE_NAME.grn`: Records of each table.
+    #   * `indexes.grn`: Index columns.
+    #   * `manifest.json`: The list of the above files.
+    #
+    # Tables are dumped concurrently by `:n_workers` threads. Workers
+    # use the context of `:database` because Ruby objects for tables
+    # and columns are bound to it. They write dump files
+    # concurrently. Use {Groonga::Context#restore_directory} to
+    # restore the directory.
+    #
+    # @return [String, nil] The dumped commands when neither `:output`
+    #   nor `:directory` is specified, `nil` otherwise.
     def dump
       options = @options.dup
+      if options[:directory]
+        dump_directory(options)
+        return nil
+      end
+
       have_output = !@options[:output].nil?
       options[:output] ||= Dumper.default_output
-      options[:error_output] ||= Dumper.default_output
-      if options[:database].nil?
-        options[:context] ||= Groonga::Context.default
-        options[:database] = options[:context].database
-      end
-      options[:dump_schema] = true if options[:dump_schema].nil?
-      options[:dump_indexes] = true if options[:dump_indexes].nil?
-      options[:dump_tables] = true if options[:dump_tables].nil?
+      fill_default_options(options)
 
       if options[:dump_schema] or options[:dump_indexes]
         schema_dumper = SchemaDumper.new(options.merge(:syntax => :command))
@@ -83,6 +106,116 @@ module Groonga
     end
 
     private
+    def fill_default_options(options)
+      options[:error_output] ||= Dumper.default_output
+      if options[:database].nil?
+        options[:context] ||= Groonga::Context.default
+        options[:database] = options[:context].database
+      end
+      options[:dump_schema] = true if options[:dump_schema].nil?
+      options[:dump_indexes] = true if options[:dump_indexes].nil?
+      options[:dump_tables] = true if options[:dump_tables].nil?
+    end
+
+    def dump_directory(options)
+      fill_default_options(options)
+      directory = options[:directory].to_s
+      FileUtils.mkdir_p(File.join(directory, "tables"))
+      manifest = {
+        "schema" => nil,
+        "tables" => [],
+        "indexes" => nil,
+      }
+
+      if options[:dump_schema]
+        manifest["schema"] = "schema.grn"
+        open_dump_file(directory, manifest["schema"]) do |output|
+          schema_options = options.merge(:output => output)
+          dump_plugins(schema_options)
+          schema_dumper =
+            SchemaDumper.new(schema_options.merge(:syntax => :command))
+          schema_dumper.dump_tables
+          if schema_dumper.have_reference_columns?
+            output.write("\n")
+            schema_dumper.dump_reference_columns
+          end
+        end
+      end
+
+      if options[:dump_tables]
+        table_files = []
+        each_target_table(options) do |table|
+          table_files << [table.name, File.join("tables", "#{table.name}.grn")]
+        end
+        dump_table_files(directory, table_files, options)
+        manifest["tables"] = table_files.collect do |_, path|
+          path
+        end
+      end
+
+      if options[:dump_indexes]
+        schema_dumper = SchemaDumper.new(options.merge(:syntax => :command))
+        if schema_dumper.have_index_columns?
+          manifest["indexes"] = "indexes.grn"
+          open_dump_file(directory, manifest["indexes"]) do |output|
+            index_options = options.merge(:syntax => :command,
+                                          :output => output)
+            SchemaDumper.new(index_options).dump_index_columns
+          end
+        end
+      end
+
+      File.write(File.join(directory, MANIFEST_FILE_NAME),
+                 JSON.pretty_generate(manifest))
+    end
+
+    def open_dump_file(directory, path, &block)
+      File.open(File.join(directory, path), "w:utf-8", &block)
+    end
+
+    def dump_table_files(directory, table_files, options)
+      n_workers = options[:n_workers] || 1
+      if n_workers <= 1 or table_files.size <= 1
+        table_files.each do |table_name, path|
+          open_dump_file(directory, path) do |output|
+            table = options[:database].context[table_name]
+            dump_records(table, options.merge(:output => output))
+          end
+        end
+        return
+      end
+
+      # Workers access the database with the GVL. So they don't use
+      # the context concurrently.
+      context = options[:database].context
+      queue = Thread::Queue.new
+      table_files.each do |table_file|
+        queue << table_file
+      end
+      queue.close
+      workers = [n_workers, table_files.size].min.times.collect do
+        Thread.new do
+          Thread.current.report_on_exception = false
+          while (table_file = queue.pop)
+            table_name, path = table_file
+            open_dump_file(directory, path) do |output|
+              dump_records(context[table_name],
+                           options.merge(:output => output))
+            end
+          end
+        end
+      end
+      errors = []
+      workers.each do |worker|
+        begin
+          worker.join
+        rescue => error
+          errors << error
+        end
+      end
+      raise errors.first unless errors.empty?
+    end
+
     def dump_plugins(options)
       plugin_paths = options[:database].plugin_paths
       plugin_paths.each do |path|
@@ -93,15 +226,21 @@ module Groonga
 
     def dump_tables(options)
       first_table = true
+      each_target_table(options) do |table|
+        options[:output].write("\n") if !first_table or options[:dump_schema]
+        first_table = false
+        dump_records(table, options)
+      end
+    end
+
+    def each_target_table(options)
       options[:database].each(each_options(:order_by => :key)) do |object|
         next unless object.is_a?(Groonga::Table)
         next if object.size.zero?
         next if index_only_table?(object)
         next if target_table?(options[:exclude_tables], object, false)
         next unless target_table?(options[:tables], object, true)
-        options[:output].write("\n") if !first_table or options[:dump_schema]
-        first_table = false
-        dump_records(object, options)
+        yield(object)
       end
     end
 
@@ -721,6 +860,7 @@ module Groonga
         order_by = nil if order_by == :key
       end
       limit = @options[:max_records]
+      return if dump_records_native(columns, order_by, limit)
       @table.each(:order_by => order_by, :limit => limit) do |record|
         write(",\n")
         values = columns.collect do |column|
@@ -0,0 +1,92 @@
+# Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # A LRU cache of {Groonga::Expression}s built by
+  # {Groonga::Table#select} with a query string.
+  #
+  # {Groonga::Table#select} parses the same query string only once
+  # when {Groonga::Context#expression_cache} is set. The cache key
+  # is the ID of the target table, the query string and the parse
+  # options such as `:syntax` and `:default_column`. Only selects on
+  # persistent tables are cached. Selects on temporary tables such
+  # as select results aren't cached.
+  #
+  # Cached expressions are shared by results of
+  # {Groonga::Table#select}. Don't change `result.expression`.
+  #
+  # @example Enable expression cache for the default context
+  #   Groonga::Context.default.expression_cache =
+  #     Groonga::ExpressionCache.new(1000)
+  #
+  # @since 15.0.5
+  class ExpressionCache
+    # @return [Integer] The max number of cached expressions.
+    attr_reader :max_size
+
+    # @return [Integer] The number of cache hits.
+    attr_reader :n_hits
+
+    # @return [Integer] The number of cache misses.
+    attr_reader :n_misses
+
+    # @param max_size [Integer] The max number of cached
+    #   expressions. The least recently used expression is removed
+    #   when the number of cached expressions exceeds it.
+    def initialize(max_size=100)
+      @max_size = max_size
+      @expressions = {}
+      @n_hits = 0
+      @n_misses = 0
+    end
+
+    # @return [Groonga::Expression, nil] The cached expression for
+    #   `key`. `nil` if there is no cached expression for `key`.
+    def [](key)
+      expression = @expressions.delete(key)
+      if expression.nil? or expression.closed?
+        @n_misses += 1
+        return nil
+      end
+      @n_hits += 1
+      @expressions[key] = expression
+    end
+
+    # Caches `expression` for `key`.
+    #
+    # @return [Groonga::Expression] `expression`.
+    def []=(key, expression)
+      @expressions.delete(key)
+      @expressions[key] = expression
+      while @expressions.size > @max_size
+        @expressions.shift
+      end
+      expression
+    end
+
+    # @return [Integer] The number of cached expressions.
+    def size
+      @expressions.size
+    end
+
+    # Removes all cached expressions. You need to call this after
+    # you remove or rename columns used by cached expressions.
+    #
+    # @return [void]
+    def clear
+      @expressions.clear
+    end
+  end
+end
@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2013  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2013-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -67,6 +67,46 @@ module Groonga
       def query_log_path=(path)
         QueryLogger.path = path
       end
+
+      private
+      def start_flush_thread(interval)
+        stop_flush_thread
+        mutex = Thread::Mutex.new
+        condition = Thread::ConditionVariable.new
+        state = {running: true}
+        @flush_thread_mutex = mutex
+        @flush_thread_condition = condition
+        @flush_thread_state = state
+        @flush_thread = Thread.new do
+          loop do
+            running = mutex.synchronize do
+              condition.wait(mutex, interval) if state[:running]
+              state[:running]
+            end
+            break unless running
+            # The logger may unregister or register a logger. So this
+            # must not hold the mutex to avoid a dead lock.
+            begin
+              flush
+            rescue Exception => error
+              $stderr.puts("#{error.class}: #{error.message}")
+              $stderr.puts(error.backtrace)
+            end
+          end
+        end
+      end
+
+      def stop_flush_thread
+        return if @flush_thread.nil?
+        flush_thread = @flush_thread
+        @flush_thread = nil
+        @flush_thread_mutex.synchronize do
+          @flush_thread_state[:running] = false
+          @flush_thread_condition.signal
+        end
+        # The logger may call this in the flush thread.
+        flush_thread.join unless flush_thread == Thread.current
+      end
     end
 
     def log(level, timestamp, title, message, location)
@@ -75,6 +115,22 @@ module Groonga
       end
     end
 
+    # Logs buffered log entries. It's called with entries in a batch
+    # when this logger is registered with `:buffered => true`. It
+    # calls {#log} for each entry by default. Override it to process
+    # entries in a batch.
+    #
+    # @param entries [::Array<::Array>] The log entries. Each entry is
+    #   `[level, timestamp, title, message, location]`.
+    # @return [void]
+    #
+    # @since 15.0.5
+    def log_entries(entries)
+      entries.each do |level, timestamp, title, message, location|
+        log(level, timestamp, title, message, location)
+      end
+    end
+
     def reopen
     end
 
@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2010-2011  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2010-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -134,6 +134,137 @@ module Groonga
       records.send(:set_pagination_info, page, page_size, _size)
       records
     end
+
+    # Keyset (cursor based) pagination. It's useful for infinite
+    # scroll that shows many pages.
+    #
+    # {#paginate} counts all records and sorts all records before
+    # the requested page for each page. {#paginate_after} doesn't
+    # count records and only sorts records after the last record of
+    # the previous page. The previous page is specified by
+    # {KeysetPagination#next_cursor} of the previous page.
+    #
+    # `_id` is always appended to `sort_keys` as the last sort key
+    # to order records that have the same sort key values.
+    #
+    # @example Show all pages
+    #   entries = Groonga["Entries"]
+    #   cursor = nil
+    #   loop do
+    #     page = entries.paginate_after([["date", :desc]],
+    #                                   :size => 10,
+    #                                   :after => cursor)
+    #     page.each do |entry|
+    #       puts entry.title
+    #     end
+    #     break unless page.have_next_page?
+    #     cursor = page.next_cursor
+    #   end
+    #
+    # @param sort_keys [::Array] The sort keys. They are the same as
+    #   {#sort} but only column names are accepted.
+    # @param options [::Hash] The name and value
+    #   pairs. Omitted names are initialized as the default value.
+    # @option options [Integer] :size (10) The max number of records
+    #   in a page.
+    # @option options [::Array, nil] :after (nil) The cursor returned
+    #   by {KeysetPagination#next_cursor} of the previous page. The
+    #   first page is returned for `nil`.
+    # @option options [Boolean] :estimate_size (false) If it's
+    #   `true`, {KeysetPagination#estimated_n_records} is computed by
+    #   {Expression#estimate_size} for a result of {#select}. It's
+    #   cheaper than counting matched records for a large table.
+    # @return [Groonga::Table] The sorted records in the page. It's
+    #   extended by {KeysetPagination}.
+    #
+    # @since 15.0.5
+    def paginate_after(sort_keys, options={})
+      page_size = options[:size] || 10
+      if page_size < 1
+        raise TooSmallPageSize.new(page_size, 1..Float::INFINITY)
+      end
+
+      keys = normalize_keyset_sort_keys(sort_keys)
+      cursor = options[:after]
+      if cursor.nil?
+        source = self
+        prefix = ""
+      else
+        if cursor.size != keys.size
+          raise ArgumentError,
+                "cursor size doesn't match sort keys: " +
+                "expected: <#{keys.size}>: actual: <#{cursor.size}>"
+        end
+        source = select do |record|
+          build_keyset_condition(record, keys, cursor)
+        end
+        prefix = "_key."
+      end
+      records = source.sort(keys.collect do |key, descending|
+                              {
+                                :key => "#{prefix}#{key}",
+                                :order => descending ? :descending : :ascending,
+                              }
+                            end,
+                            :limit => page_size)
+
+      estimated_n_records = nil
+      if options[:estimate_size]
+        if respond_to?(:expression) and expression
+          estimated_n_records = expression.estimate_size
+        else
+          estimated_n_records = size
+        end
+      end
+      records.extend(KeysetPagination)
+      records.send(:set_keyset_pagination_info,
+                   keys,
+                   page_size,
+                   source.size > page_size,
+                   !cursor.nil?,
+                   estimated_n_records)
+      records
+    end
+
+    private
+    def normalize_keyset_sort_keys(sort_keys)
+      keys = sort_keys.collect do |sort_key|
+        case sort_key
+        when ::Hash
+          key = sort_key[:key]
+          order = sort_key[:order]
+        when ::Array
+          key, order = sort_key
+        else
+          key = sort_key
+          order = nil
+        end
+        key = key.local_name if key.is_a?(Column)
+        descending = ["desc", "descending"].include?(order.to_s)
+        [key.to_s, descending]
+      end
+      keys << ["_id", false] unless keys.last == ["_id", false]
+      keys
+    end
+
+    def build_keyset_condition(record, keys, cursor)
+      conditions = keys.each_with_index.collect do |(key, descending), i|
+        condition = nil
+        keys[0, i].each_with_index do |(previous_key, _), j|
+          equal = (record[previous_key] == cursor[j])
+          condition = condition ? (condition & equal) : equal
+        end
+        if descending
+          after = (record[key] < cursor[i])
+        else
+          after = (record[key] > cursor[i])
+        end
+        condition ? (condition & after) : after
+      end
+      conditions.inject do |condition, other_condition|
+        condition | other_condition
+      end
+    end
   end
 
   # ページネーション機能を追加するモジュール。
@@ -240,4 +371,61 @@ module Groonga
       @n_pages = [(@n_records / @page_size.to_f).ceil, 1].max
     end
   end
+
+  # A module to add keyset pagination information to a result of
+  # {Table#paginate_after}.
+  #
+  # @since 15.0.5
+  module KeysetPagination
+    # @return [Integer] The max number of records in a page.
+    attr_reader :page_size
+
+    # @return [Integer, nil] The estimated number of all records. It's
+    #   `nil` unless `:estimate_size` is specified.
+    attr_reader :estimated_n_records
+
+    # @return [Boolean] `true` if there are more records after this
+    #   page, `false` otherwise.
+    def have_next_page?
+      @have_next_page
+    end
+
+    # @return [Boolean] `true` if this page isn't the first page,
+    #   `false` otherwise.
+    def have_previous_page?
+      @have_previous_page
+    end
+
+    # @return [::Array, nil] The cursor for the next page. Pass it to
+    #   `:after` of {Table#paginate_after}. It's the sort key values
+    #   and the ID of the last record in this page. `nil` if there is
+    #   no next page.
+    def next_cursor
+      return nil unless have_next_page?
+      last_record = nil
+      each do |record|
+        last_record = record
+      end
+      return nil if last_record.nil?
+      record = last_record.value
+      record = record.key if @have_previous_page
+      @keyset_sort_keys.collect do |key, _|
+        if key == "_id"
+          record.id
+        else
+          record[key]
+        end
+      end
+    end
+
+    private
+    def set_keyset_pagination_info(sort_keys, page_size, have_next_page,
+                                   have_previous_page, estimated_n_records)
+      @keyset_sort_keys = sort_keys
+      @page_size = page_size
+      @have_next_page = have_next_page
+      @have_previous_page = have_previous_page
+      @estimated_n_records = estimated_n_records
+    end
+  end
 end
@@ -49,9 +49,44 @@ module Groonga
     #   # "<span class=\"keyword\">muTEki(muteki)</span>\n" +
     #   # " マッチしない &lt;&gt; " +
     #   # "<span class=\"keyword\">ガッ(ガッ)</span>\n"
-    def tag_keys(text, options={})
+    #
+    # @example Tag keys in C without block
+    #   words.tag_keys(text,
+    #                  :open_tag => "<a href=\"/words/%{id}\">",
+    #                  :close_tag => "</a>")
+    #
+    # @option options [String] :open_tag The tag inserted before each
+    #   matched word. Each `%{id}` in it is replaced with the record
+    #   ID of the matched key. It's used when no block is given.
+    #
+    #   It's faster than the block because all tags are inserted in
+    #   C. {Groonga::Record} isn't created for each matched word.
+    #
+    #   @since 15.0.5
+    # @option options [String] :close_tag The tag inserted after each
+    #   matched word. It's used when no block is given.
+    #
+    #   @since 15.0.5
+    def tag_keys(text, options={}, &block)
       options ||= {}
       other_text_handler = options[:other_text_handler]
+      unless block
+        open_tag = options[:open_tag]
+        close_tag = options[:close_tag]
+        if open_tag.nil? or close_tag.nil?
+          raise ArgumentError,
+                "block or both of :open_tag and :close_tag are required"
+        end
+        if other_text_handler
+          block = lambda do |record, word|
+            "#{open_tag.gsub("%{id}", record.id.to_s)}#{word}#{close_tag}"
+          end
+        else
+          open_tag_parts = open_tag.split("%{id}", -1)
+          open_tag_parts = [""] if open_tag_parts.empty?
+          return tag_keys_native(text, open_tag_parts, close_tag)
+        end
+      end
       position = 0
       result = +""
       if text.respond_to?(:encoding)
@@ -68,7 +103,7 @@ module Groonga
           previous_text = other_text_handler.call(previous_text)
         end
         result << previous_text
-        result << yield(record, word)
+        result << block.call(record, word)
         position = start + length
       end
       last_text = bytes[position..-1]
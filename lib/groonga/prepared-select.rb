@@ -0,0 +1,108 @@
+# Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+module Groonga
+  # A select condition that is parsed and compiled only once. It can
+  # be executed many times with different variable values.
+  #
+  # Use {Groonga::Table#prepare_select} to create it.
+  #
+  # @since 15.0.5
+  class PreparedSelect
+    # @return [Groonga::Table] The target table.
+    attr_reader :table
+    # @return [Groonga::Expression] The compiled expression.
+    attr_reader :expression
+
+    # @api private
+    def initialize(table, template, options={})
+      options = options.dup
+      variables = options.delete(:variables) || {}
+      @table = table
+      @expression = Expression.new(:context => @table.context)
+      @expression.define_variable(:domain => @table)
+      @variables = {}
+      variables.each do |name, default_value|
+        name = name.to_s
+        variable = @expression.define_variable(:name => name)
+        variable.value = default_value unless default_value.nil?
+        @variables[name] = variable
+      end
+      options[:syntax] ||= :script
+      @expression.parse(template, options)
+      @expression.compile
+    end
+
+    # @return [::Array<String>] The names of the variables.
+    def variable_names
+      @variables.keys
+    end
+
+    # Sets variable values and selects records with the compiled
+    # expression. The template isn't parsed again.
+    #
+    # @param bindings [::Hash{String, Symbol => Object}] The variable
+    #   names and their values. Variables that aren't specified keep
+    #   their previous values.
+    # @param options [::Hash] The options for {Groonga::Table#select}
+    #   such as `:result` and `:operator`.
+    # @return [Groonga::Hash] The result table.
+    def execute(bindings={}, options={})
+      bindings.each do |name, value|
+        variable = @variables[name.to_s]
+        if variable.nil?
+          raise ArgumentError,
+                "unknown variable: <#{name}>: " +
+                "available: #{variable_names.inspect}"
+        end
+        variable.value = value
+      end
+      @table.select(@expression, options)
+    end
+
+    # Closes the compiled expression.
+    #
+    # @return [void]
+    def close
+      @expression.close
+    end
+  end
+
+  class Table
+    # Parses and compiles `template` once for repeated
+    # {Groonga::Table#select}. Variables in `template` are referred
+    # by their names in script syntax.
+    #
+    # @example Prepare a select with a variable and execute it.
+    #   prepared = users.prepare_select("name @^ prefix",
+    #                                   :variables => {"prefix" => ""})
+    #   alice_result = prepared.execute("prefix" => "ali")
+    #   bob_result = prepared.execute("prefix" => "bo")
+    #
+    # @param template [String] The condition in script syntax by
+    #   default.
+    # @param options [::Hash] The options for
+    #   {Groonga::Expression#parse} such as `:default_column`.
+    # @option options :variables [::Hash{String => Object}, ::Array<String>]
+    #   The variable names that are used in `template`. If a Hash
+    #   is specified, its values are used as the initial values.
+    # @return [Groonga::PreparedSelect] The prepared select.
+    #
+    # @since 15.0.5
+    def prepare_select(template, options={})
+      PreparedSelect.new(self, template, options)
+    end
+  end
+end
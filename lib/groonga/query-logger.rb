@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2012  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2012-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -48,6 +48,9 @@ module Groonga
           when Integer
             input | base_flags
           when String, Symbol
+            if input.is_a?(String) and input.include?("|")
+              return parse(input.split("|"), base_flags)
+            end
             value = NAMES[input.to_sym]
             if value.nil?
               message =
@@ -0,0 +1,229 @@
+# Copyright (C) 2025  Sutou Kouhei <kou@clear-code.com>
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License version 2.1 as published by the Free Software Foundation.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+require "etc"
+
+module Groonga
+  # A pool of Ractors that run read-only searches against a database
+  # in parallel. Each Ractor opens the database with its own
+  # {Groonga::Context} once. Opened files are mmap-ed, so their pages
+  # are shared by all Ractors.
+  #
+  # Results are returned as deeply frozen Arrays of column values.
+  # A reference column value is returned as the key of the referred
+  # record, or as its ID if the referred table has no key.
+  #
+  # The database must not be changed while the pool is used.
+  #
+  # @example Search with 4 Ractors
+  #   pool = Groonga::SearchPool.new("/tmp/db", :n_workers => 4)
+  #   begin
+  #     results = pool.search_many([
+  #       ["Comments", "content:@Groonga", {:columns => ["content"]}],
+  #       ["Comments", "content:@Ruby", {:columns => ["content"]}],
+  #     ])
+  #   ensure
+  #     pool.close
+  #   end
+  #
+  # @since 15.0.5
+  class SearchPool
+    class << self
+      # @api private
+      def run_worker(database_path, encoding)
+        Context.open(:encoding => encoding) do |context|
+          context.open_database(database_path) do
+            while (message = Ractor.receive)
+              reply, request = message
+              response = process_request(context, request)
+              if reply
+                reply << response
+              else
+                Ractor.yield(response)
+              end
+            end
+          end
+        end
+      end
+
+      private
+      def process_request(context, request)
+        table_name, query, options = request
+        records = search(context, table_name, query, options || {})
+        Ractor.make_shareable([:success, records])
+      rescue => error
+        Ractor.make_shareable([:error, error.class.name, error.message])
+      end
+
+      def search(context, table_name, query, options)
+        table = context[table_name]
+        if table.nil?
+          raise ArgumentError, "nonexistent table: <#{table_name}>"
+        end
+        if query
+          select_options = {}
+          select_options[:syntax] = options[:syntax] if options[:syntax]
+          if options[:default_column]
+            select_options[:default_column] = options[:default_column]
+          end
+          result = table.select(query, select_options)
+        else
+          result = table
+        end
+        begin
+          offset = options[:offset] || 0
+          limit = options[:limit] || -1
+          columns = options[:columns] || ["_id"]
+          if options[:sort_keys]
+            records = result.sort(options[:sort_keys],
+                                  :offset => offset,
+                                  :limit => limit)
+          else
+            records = result.each(:offset => offset, :limit => limit)
+          end
+          records.collect do |record|
+            columns.collect do |column|
+              normalize_value(record[column])
+            end
+          end
+        ensure
+          result.close unless result.equal?(table)
+        end
+      end
+
+      def normalize_value(value)
+        case value
+        when Record
+          if value.table.support_key?
+            value.key
+          else
+            value.id
+          end
+        when ::Array
+          value.collect {|sub_value| normalize_value(sub_value)}
+        else
+          value
+        end
+      end
+    end
+
+    # @return [Integer] The number of Ractors.
+    attr_reader :n_workers
+
+    # @param database_path [String] The path of the target database.
+    # @param options [::Hash] The options.
+    # @option options :n_workers [Integer] (the number of processors)
+    #   The number of Ractors.
+    # @option options :encoding [Symbol, String] (Context.default.encoding)
+    #   The encoding of each Ractor's context.
+    def initialize(database_path, options={})
+      unless defined?(Ractor)
+        raise NotImplementedError, "Ractor is needed for SearchPool"
+      end
+      @n_workers = options[:n_workers] || Etc.nprocessors
+      encoding = options[:encoding] || Context.default.encoding
+      encoding = encoding.to_s if encoding
+      database_path = Ractor.make_shareable(database_path.to_s.dup)
+      @workers = @n_workers.times.collect do
+        Ractor.new(database_path, encoding) do |path, worker_encoding|
+          Groonga::SearchPool.run_worker(path, worker_encoding)
+        end
+      end
+      @next_worker_index = 0
+    end
+
+    # Searches records by one of the Ractors.
+    #
+    # @param table_name [String] The name of the target table.
+    # @param query [String, nil] The query passed to
+    #   {Groonga::Table#select}. All records are the target when
+    #   it's `nil`.
+    # @param options [::Hash] The options.
+    # @option options :syntax [Symbol] (:query) The syntax of `query`.
+    # @option options :default_column [String] The default column
+    #   of `query`.
+    # @option options :sort_keys [::Array] The sort keys passed to
+    #   {Groonga::Table#sort}.
+    # @option options :offset [Integer] (0) The offset of records.
+    # @option options :limit [Integer] (-1) The max number of records.
+    #   All records are returned when it's negative.
+    # @option options :columns [::Array<String>] (["_id"]) The names
+    #   of returned columns.
+    # @return [::Array<::Array>] The frozen column values of matched
+    #   records.
+    def search(table_name, query=nil, options={})
+      search_many([[table_name, query, options]]).first
+    end
+
+    # Searches records by all Ractors in parallel.
+    #
+    # @param requests [::Array<::Array>] `[table_name, query, options]`
+    #   for each search. See {#search} for details.
+    # @return [::Array<::Array<::Array>>] The results in the same
+    #   order as `requests`.
+    def search_many(requests)
+      if @workers.nil?
+        raise Closed, "can't use closed search pool"
+      end
+      receivers = requests.collect do |request|
+        dispatch(request)
+      end
+      results = receivers.collect do |receiver|
+        status, *payload = receiver.call
+        if status == :error
+          error_class_name, message = payload
+          raise Error, "#{error_class_name}: #{message}"
+        end
+        payload.first
+      end
+      results.freeze
+    end
+
+    # Stops all Ractors.
+    #
+    # @return [void]
+    def close
+      return if @workers.nil?
+      @workers.each do |worker|
+        worker.send(nil)
+      end
+      @workers.each do |worker|
+        # Ractor#take was replaced at Ruby 3.5.
+        # https://bugs.ruby-lang.org/issues/21262
+        worker.respond_to?(:take) ? worker.take : worker.value
+      end
+      @workers = nil
+    end
+
+    # @return [Boolean] `true` if the pool is closed, `false` otherwise.
+    def closed?
+      @workers.nil?
+    end
+
+    private
+    def dispatch(request)
+      worker = @workers[@next_worker_index]
+      @next_worker_index = (@next_worker_index + 1) % @workers.size
+      if defined?(Ractor::Port)
+        port = Ractor::Port.new
+        worker.send([port, request])
+        lambda {port.receive}
+      else
+        worker.send([nil, request])
+        lambda {worker.take}
+      end
+    end
+  end
+end
@@ -18,6 +18,7 @@ require "erb"
 require "fileutils"
 require "json"
 require "pathname"
+require "socket"
 require "stringio"
 require "tempfile"
 require "time"
@@ -1,4 +1,4 @@
-# Copyright (C) 2018  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2018-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -43,4 +43,59 @@ class ColumnCacheTest < Test::Unit::TestCase
                    @users.collect {|user| column_cache[user]})
     end
   end
+
+  def test_each_buffer
+    omit("IO::Buffer is required") unless defined?(IO::Buffer)
+    chunks = []
+    Groonga::ColumnCache.open(@age) do |column_cache|
+      column_cache.each_buffer do |buffer, first_id|
+        chunks << [first_id, buffer.get_string.unpack("l*")]
+      end
+    end
+    assert_equal([[1, [9, 19, 29]]],
+                 chunks)
+  end
+
+  def test_each_buffer_multiple_segments
+    omit("IO::Buffer is required") unless defined?(IO::Buffer)
+    Groonga::Schema.define do |schema|
+      schema.create_table("Logs", :type => :array) do |table|
+        table.integer64("value")
+      end
+    end
+    logs = context["Logs"]
+    # A segment of a fixed size column is 4MiB. So 524288 Int64
+    # values are stored in one segment.
+    n_records = 600_000
+    n_records.times do
+      logs.add
+    end
+    target_ids = [1, 524_288, 524_289, n_records]
+    value_column = logs.column("value")
+    target_ids.each do |id|
+      value_column[id] = id
+    end
+
+    chunks = []
+    Groonga::ColumnCache.open(value_column) do |column_cache|
+      column_cache.each_buffer do |buffer, first_id|
+        chunks << [first_id, buffer.get_string.unpack("q*")]
+      end
+    end
+    values = chunks.flat_map {|_, chunk_values| chunk_values}
+    assert_equal([
+                   true,
+                   true,
+                   n_records,
+                   target_ids.collect {|id| [id, id]},
+                 ],
+                 [
+                   chunks.size > 1,
+                   chunks.each_cons(2).all? do |(id, chunk_values), (next_id, _)|
+                     id + chunk_values.size == next_id
+                   end,
+                   values.size,
+                   target_ids.collect {|id| [id, values[id - 1]]},
+                 ])
+  end
 end
@@ -1,4 +1,4 @@
-# Copyright (C) 2009-2018  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 # Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
@@ -157,6 +157,38 @@ class ContextTest < Test::Unit::TestCase
     end
   end
 
+  sub_test_case("#release_gvl?") do
+    def test_default
+      assert do
+        not Groonga::Context.new.release_gvl?
+      end
+    end
+
+    def test_option
+      context = Groonga::Context.new(release_gvl: true)
+      assert do
+        context.release_gvl?
+      end
+    end
+
+    def test_default_options
+      Groonga::Context.default_options = {
+        :release_gvl => true,
+      }
+      assert do
+        Groonga::Context.default.release_gvl?
+      end
+    end
+
+    def test_set
+      context = Groonga::Context.new
+      context.release_gvl = true
+      assert do
+        context.release_gvl?
+      end
+    end
+  end
+
   def test_close
     context = Groonga::Context.new
     assert_false(context.closed?)
@@ -172,6 +204,92 @@ class ContextTest < Test::Unit::TestCase
     end
   end
 
+  def test_reopen_after_fork
+    omit("fork is needed") unless Process.respond_to?(:fork)
+    setup_database
+    users = Groonga::Array.create(:name => "Users")
+    users.add
+    users.add
+    read_io, write_io = IO.pipe
+    pid = fork do
+      read_io.close
+      Groonga.after_fork
+      write_io.puts(Groonga::Context.default["Users"].size)
+      write_io.close
+      exit!(true)
+    end
+    write_io.close
+    n_users = read_io.read
+    read_io.close
+    _, status = Process.waitpid2(pid)
+    assert_equal(["2\n", true],
+                 [n_users, status.success?])
+  end
+
+  def test_reopen_after_fork_gc
+    omit("fork is needed") unless Process.respond_to?(:fork)
+    setup_database
+    users = Groonga::Array.create(:name => "Users")
+    users.add
+    read_io, write_io = IO.pipe
+    GC.disable
+    begin
+      # Objects that are created in the parent process and are freed
+      # in the child process.
+      10.times do
+        Groonga::Hash.create(:key_type => "ShortText")
+        context["Users"].select
+      end
+      pid = fork do
+        read_io.close
+        Groonga.after_fork
+        GC.enable
+        GC.start
+        write_io.puts(Groonga::Context.default["Users"].size)
+        write_io.close
+        exit(true)
+      end
+    ensure
+      GC.enable
+    end
+    write_io.close
+    n_users = read_io.read
+    read_io.close
+    _, status = Process.waitpid2(pid)
+    assert_equal(["1\n", true, 1],
+                 [n_users, status.success?, users.size])
+  end
+
+  def test_reopen_after_fork_connected_without_options
+    omit("fork is needed") unless Process.respond_to?(:fork)
+    begin
+      # #connect without options connects to localhost:10041.
+      server = TCPServer.new("localhost", 10041)
+    rescue SystemCallError
+      omit("the default port is already used")
+    end
+    begin
+      _context = Groonga::Context.new
+      _context.connect
+      read_io, write_io = IO.pipe
+      pid = fork do
+        read_io.close
+        _context.reopen_after_fork
+        write_io.puts(_context.connected?)
+        write_io.close
+        exit!(true)
+      end
+      write_io.close
+      connected = read_io.read
+      read_io.close
+      _, status = Process.waitpid2(pid)
+      assert_equal(["true\n", true],
+                   [connected, status.success?])
+    ensure
+      server.close
+    end
+  end
+
   class RestoreTest < self
     def test_simple
       commands = <<EOD
@@ -242,6 +360,120 @@ COMMANDS
                    responses)
     end
 
+    def test_directory
+      source_context = Groonga::Context.new
+      source_context.create_database((@tmp_dir + "source.db").to_s) do
+        source_context.restore(<<-COMMANDS)
+table_create Users TABLE_HASH_KEY ShortText
+column_create Users name COLUMN_SCALAR ShortText
+
+table_create Tags TABLE_PAT_KEY ShortText
+
+table_create Posts TABLE_NO_KEY
+column_create Posts title COLUMN_SCALAR ShortText
+column_create Posts author COLUMN_SCALAR Users
+
+column_create Users posts_author COLUMN_INDEX Posts author
+
+load --table Users
+[
+{"_key":"alice","name":"Alice"},
+{"_key":"bob","name":"Bob"}
+]
+
+load --table Tags
+[
+{"_key":"groonga"}
+]
+
+load --table Posts
+[
+{"title":"Hello","author":"alice"},
+{"title":"World","author":"bob"}
+]
+        COMMANDS
+        Groonga::DatabaseDumper.dump(:context => source_context,
+                                     :directory => @tmp_dir + "dump")
+      end
+
+      restore_context = Groonga::Context.new
+      restore_context.create_database(@database_path.to_s) do
+        restore_context.restore_directory(@tmp_dir + "dump",
+                                          :n_workers => 2)
+      end
+
+      assert_equal(<<-EOC, dump)
+table_create Posts TABLE_NO_KEY
+column_create Posts title COLUMN_SCALAR ShortText
+
+table_create Tags TABLE_PAT_KEY ShortText
+
+table_create Users TABLE_HASH_KEY ShortText
+column_create Users name COLUMN_SCALAR ShortText
+
+column_create Posts author COLUMN_SCALAR Users
+
+load --table Posts
+[
+["_id","author","title"],
+[1,"alice","Hello"],
+[2,"bob","World"]
+]
+
+load --table Tags
+[
+["_key"],
+["groonga"]
+]
+
+load --table Users
+[
+["_key","name"],
+["alice","Alice"],
+["bob","Bob"]
+]
+
+column_create Users posts_author COLUMN_INDEX Posts author
+EOC
+    end
+
+    def test_directory_temporary_database
+      source_context = Groonga::Context.new
+      source_context.create_database((@tmp_dir + "source.db").to_s) do
+        source_context.restore(<<-COMMANDS)
+table_create Users TABLE_HASH_KEY ShortText
+table_create Tags TABLE_PAT_KEY ShortText
+
+load --table Users
+[
+{"_key":"alice"},
+{"_key":"bob"}
+]
+
+load --table Tags
+[
+{"_key":"groonga"}
+]
+        COMMANDS
+        Groonga::DatabaseDumper.dump(:context => source_context,
+                                     :directory => @tmp_dir + "dump")
+      end
+
+      restore_context = Groonga::Context.new
+      restore_context.create_database do
+        restore_context.restore_directory(@tmp_dir + "dump",
+                                          :n_workers => 2)
+        assert_equal([
+                       ["alice", "bob"],
+                       ["groonga"],
+                     ],
+                     [
+                       restore_context["Users"].collect(&:key).sort,
+                       restore_context["Tags"].collect(&:key),
+                     ])
+      end
+    end
+
     private
     def restore(commands, &block)
       restore_context = Groonga::Context.new
@@ -274,6 +274,36 @@ load --table Users
     def test_no_tables
       assert_equal(dumped_schema, dump(:dump_tables => false))
     end
+
+    def test_directory
+      directory = @tmp_dir + "dump"
+      assert_nil(dump(:directory => directory, :n_workers => 2))
+      manifest = JSON.parse((directory + "manifest.json").read)
+      dumped_files = [manifest["schema"], *manifest["tables"], manifest["indexes"]]
+      assert_equal([
+                     {
+                       "schema" => "schema.grn",
+                       "tables" => [
+                         "tables/Posts.grn",
+                         "tables/Tags.grn",
+                         "tables/Users.grn",
+                       ],
+                       "indexes" => "indexes.grn",
+                     },
+                     [
+                       "#{dumped_schema_tables}\n\n" +
+                       "#{dumped_schema_reference_columns}\n",
+                       "#{dumped_table_posts}\n",
+                       "#{dumped_table_tags}\n",
+                       "#{dumped_table_users}\n",
+                       "#{dumped_schema_index_columns}\n",
+                     ],
+                   ],
+                   [
+                     manifest,
+                     dumped_files.collect {|path| (directory + path).read},
+                   ])
+    end
   end
 
   class PluginTest < self
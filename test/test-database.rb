@@ -275,6 +275,94 @@ class DatabaseTest < Test::Unit::TestCase
                  terms.collect(&:_key).sort)
   end
 
+  def test_reindex_parallel
+    setup_database
+    Groonga::Schema.define do |schema|
+      schema.create_table("Memos",
+                          :type => :array) do |table|
+        table.column("title", "ShortText")
+        table.column("content", "Text")
+      end
+      schema.create_table("Terms",
+                          :type => :patricia_trie,
+                          :key_type => "ShortText",
+                          :default_tokenizer => "TokenBigram",
+                          :normalizer => "NormalizerAuto") do |table|
+        table.index("Memos.title")
+        table.index("Memos.content")
+      end
+      schema.create_table("Titles",
+                          :type => :hash,
+                          :key_type => "ShortText") do |table|
+        table.index("Memos.title")
+      end
+    end
+
+  def test_reindex_parallel_error
+    setup_database
+    Groonga::Schema.define do |schema|
+      schema.create_table("Memos",
+                          :type => :array) do |table|
+        table.column("title", "ShortText")
+      end
+      schema.create_table("Terms",
+                          :type => :patricia_trie,
+                          :key_type => "ShortText",
+                          :default_tokenizer => "TokenBigram",
+                          :normalizer => "NormalizerAuto") do |table|
+        table.index("Memos.title")
+      end
+      schema.create_table("Titles",
+                          :type => :hash,
+                          :key_type => "ShortText") do |table|
+        table.index("Memos.title")
+      end
+    end
+
+    progress = Groonga::Database::ReindexProgress.new
+    assert_raise(RuntimeError) do
+      @database.reindex_parallel(:n_workers => 2,
+                                 :progress => progress) do |current|
+        raise "failed"
+      end
+    end
+    # All workers are finished before the error is raised.
+    assert_equal(2, progress.n_done_indexes)
+  end
+
+    memos = context["Memos"]
+    memos.add(:title => "memo", :content => "This is a memo")
+
+    terms = context["Terms"]
+    terms.delete("this")
+
+    n_done_indexes = []
+    progress = @database.reindex_parallel(:n_workers => 2) do |current|
+      n_done_indexes << current.n_done_indexes
+    end
+
+    assert_equal([
+                   [1, 2, 3],
+                   3,
+                   true,
+                   1.0,
+                   [
+                     "Terms.Memos_content",
+                     "Terms.Memos_title",
+                     "Titles.Memos_title",
+                   ],
+                   ["a", "is", "memo", "this"],
+                 ],
+                 [
+                   n_done_indexes,
+                   progress.n_indexes,
+                   progress.done?,
+                   progress.ratio,
+                   progress.done_index_names.sort,
+                   terms.collect(&:_key).sort,
+                 ])
+  end
+
   def test_remove_force
     setup_database
     table_name = "Bookmarks"
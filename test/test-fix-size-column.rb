@@ -164,6 +164,48 @@ class FixSizeColumnTest < Test::Unit::TestCase
       assert_equal(@bookmarks, @n_viewed.table)
     end
 
+    class ValuesAtTest < self
+      def setup
+        super
+        @bookmarks.add(:n_viewed => 10)
+        @bookmarks.add(:n_viewed => 20)
+        @bookmarks.add(:n_viewed => 30)
+      end
+
+      def test_ids
+        assert_equal([30, 10, nil],
+                     @n_viewed.values_at([3, 1, nil]))
+      end
+
+      def test_records
+        records = [
+          Groonga::Record.new(@bookmarks, 2),
+          Groonga::Record.new(@bookmarks, 3),
+        ]
+        assert_equal([20, 30],
+                     @n_viewed.values_at(records))
+      end
+
+      def test_nil
+        assert_equal([10, 20, 30],
+                     @n_viewed.values_at(nil))
+      end
+
+      def test_result
+        result = @bookmarks.select do |record|
+          record.n_viewed > 10
+        end
+        assert_equal([20, 30],
+                     @n_viewed.values_at(result))
+      end
+
+      def test_packed
+        assert_equal([30, 10, 0],
+                     @n_viewed.values_at([3, 1, nil],
+                                         :packed => true).unpack("l*"))
+      end
+    end
+
     class AssignTest < self
       def test_different_types
         @bookmarks.add(:n_viewed => "100")
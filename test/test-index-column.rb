@@ -1,4 +1,4 @@
-# Copyright (C) 2009-2021  Sutou Kouhei <kou@clear-code.com>
+# Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 # Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
@@ -679,6 +679,18 @@ class IndexColumnTest < Test::Unit::TestCase
         end
         assert_equal(expected, actual)
       end
+
+      def test_release_gvl
+        context.release_gvl = true
+        @memos.add("Rroonga is fun!", :tags => ["rroonga", "groonga"])
+        @memos.add("Groonga is fast!", :tags => ["groonga"])
+
+        actual = @index.search("groonga").collect do |record|
+          record._key
+        end
+        assert_equal(["Rroonga is fun!", "Groonga is fast!"],
+                     actual)
+      end
     end
   end
 
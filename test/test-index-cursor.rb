@@ -132,6 +132,40 @@ class IndexCursorTest < Test::Unit::TestCase
     assert_true(opened)
   end
 
+  def test_read_batch
+    batches = []
+    @terms.open_cursor do |table_cursor|
+      @content_index.open_cursor(table_cursor) do |cursor|
+        while (columns = cursor.read_batch(3))
+          batches << columns[:record_id].unpack("L*")
+        end
+      end
+    end
+
+    assert_equal([[1, 2, 2], [3, 3, 3], [3, 3]],
+                 batches)
+  end
+
+  def test_to_columns
+    columns = nil
+    @terms.open_cursor do |table_cursor|
+      @content_index.open_cursor(table_cursor) do |cursor|
+        columns = cursor.to_columns
+      end
+    end
+
+    unpacked_columns = {}
+    columns.each do |name, packed_values|
+      unpacked_columns[name] = packed_values.unpack("L*")
+    end
+    postings = expected_postings(:with_position => true)
+    expected_columns = {}
+    unpacked_columns.each_key do |name|
+      expected_columns[name] = postings.collect {|posting| posting[name]}
+    end
+    assert_equal(expected_columns, unpacked_columns)
+  end
+
   def test_record
     record = nil
     @terms.open_cursor do |table_cursor|
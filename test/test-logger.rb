@@ -1,4 +1,4 @@
-# Copyright (C) 2010-2019  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2010-2025  Sutou Kouhei <kou@clear-code.com>
 # Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
@@ -194,6 +194,122 @@ class LoggerTest < Test::Unit::TestCase
                    ],
                    locations)
     end
+
+    test ":buffered" do
+      messages = []
+      Groonga::Logger.register(buffered: true,
+                               flush_interval: 60) do |event, *args|
+        messages << args[3] if event == :log
+      end
+      Groonga::Logger.log("message1")
+      Groonga::Logger.log("message2")
+      delivered_messages = messages.dup
+      Groonga::Logger.flush
+      assert_equal([
+                     [],
+                     ["message1", "message2"],
+                   ],
+                   [
+                     delivered_messages,
+                     messages,
+                   ])
+    end
+
+    test ":buffer_size" do
+      messages = []
+      Groonga::Logger.register(buffered: true,
+                               buffer_size: 1,
+                               flush_interval: 60) do |event, *args|
+        messages << args[3] if event == :log
+      end
+      n_dropped_entries = Groonga::Logger.n_dropped_entries
+      Groonga::Logger.log("message1")
+      Groonga::Logger.log("message2")
+      Groonga::Logger.flush
+      assert_equal([
+                     ["message2"],
+                     1,
+                   ],
+                   [
+                     messages,
+                     Groonga::Logger.n_dropped_entries - n_dropped_entries,
+                   ])
+    end
+
+    test ":buffered: error in logger" do
+      logger_class = Class.new(Groonga::Logger) do
+        attr_reader :messages
+        def initialize
+          super
+          @messages = Thread::Queue.new
+          @n_calls = 0
+        end
+
+        def log_entries(entries)
+          @n_calls += 1
+          raise "failed to log" if @n_calls == 1
+          entries.each do |_level, _timestamp, _title, message, _location|
+            @messages << message
+          end
+        end
+      end
+      logger = logger_class.new
+      Groonga::Logger.register(logger,
+                               buffered: true,
+                               flush_interval: 0.01)
+      original_stderr = $stderr
+      stderr = StringIO.new
+      $stderr = stderr
+      begin
+        Groonga::Logger.log("message1")
+        Timeout.timeout(5) do
+          sleep(0.01) until stderr.string.include?("failed to log")
+        end
+        Groonga::Logger.log("message2")
+        message = Timeout.timeout(5) do
+          logger.messages.pop
+        end
+      ensure
+        $stderr = original_stderr
+      end
+      assert_equal("message2", message)
+    end
+
+    test ":buffered: unregister in logger" do
+      unregistered = Thread::Queue.new
+      Groonga::Logger.register(buffered: true,
+                               flush_interval: 0.01) do |event, *args|
+        if event == :log
+          Groonga::Logger.unregister
+          unregistered << args[3]
+        end
+      end
+      Groonga::Logger.log("message")
+      message = Timeout.timeout(5) do
+        unregistered.pop
+      end
+      assert_equal("message", message)
+    end
+
+    test ":buffered: exit" do
+      only_not_windows
+      read_io, write_io = IO.pipe
+      pid = fork do
+        read_io.close
+        Groonga::Logger.register(buffered: true,
+                                 flush_interval: 60) do |event, *args|
+          write_io.puts(args[3]) if event == :log
+        end
+        Groonga::Logger.log("message")
+        exit(true)
+      end
+      write_io.close
+      messages = read_io.read
+      read_io.close
+      _, status = Process.waitpid2(pid)
+      assert_equal(["message\n", true],
+                   [messages, status.success?])
+    end
   end
 
   def test_rotate_threshold_size
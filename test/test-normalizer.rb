@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2012-2015  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2012-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -55,4 +55,31 @@ class NormalizerTest < Test::Unit::TestCase
       assert_equal("", Groonga::Normalizer.normalize(""))
     end
   end
+
+  sub_test_case(".normalize_many") do
+    def test_normal
+      assert_equal(["abc", "", "defgh"],
+                   Groonga::Normalizer.normalize_many(["AbC", "", "Def　gh"]))
+    end
+
+    def test_normalizer
+      assert_equal(["abc def"],
+                   Groonga::Normalizer.normalize_many(["AbC Def"],
+                                                      :normalizer => "NormalizerAuto",
+                                                      :remove_blank => false))
+    end
+
+    def test_with_checks_and_types
+      results = Groonga::Normalizer.normalize_many(["AbC", "ｄ"],
+                                                   :with_checks => true,
+                                                   :with_types => true)
+      assert_equal([
+                     ["abc", [1, 1, 1], 3],
+                     ["d", [3], 1],
+                   ],
+                   results.collect {|normalized, checks, types|
+                     [normalized, checks.unpack("s*"), types.bytesize]
+                   })
+    end
+  end
 end
@@ -1,4 +1,4 @@
-# Copyright (C) 2010  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2010-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -223,6 +223,45 @@ class PaginationTest < Test::Unit::TestCase
                     :size => 50)
   end
 
+  def test_paginate_after
+    first_page = @users.paginate_after([["number"]], :size => 7)
+    second_page = @users.paginate_after([["number"]],
+                                        :size => 7,
+                                        :after => first_page.next_cursor)
+    assert_equal([
+                   (1..7).collect {|i| "user#{i}"},
+                   [7, @users["user7"].id],
+                   (8..14).collect {|i| "user#{i}"},
+                   [true, true],
+                 ],
+                 [
+                   first_page.collect {|record| record.value.key},
+                   first_page.next_cursor,
+                   second_page.collect {|record| record.value.key.key},
+                   [second_page.have_previous_page?,
+                    second_page.have_next_page?],
+                 ])
+  end
+
+  def test_paginate_after_last_page
+    page = @users.paginate_after([["number", :desc]],
+                                 :size => 10,
+                                 :after => [3, @users["user3"].id],
+                                 :estimate_size => true)
+    assert_equal([
+                   ["user2", "user1"],
+                   false,
+                   nil,
+                   150,
+                 ],
+                 [
+                   page.collect {|record| record.value.key.key},
+                   page.have_next_page?,
+                   page.next_cursor,
+                   page.estimated_n_records,
+                 ])
+  end
+
   private
   def assert_paginate(expected, options={})
     users = @users.paginate([["number"]], options)
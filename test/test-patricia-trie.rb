@@ -1,4 +1,4 @@
-# Copyright (C) 2009-2022  Sutou Kouhei <kou@clear-code.com>
+# Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -171,6 +171,29 @@ class PatriciaTrieTest < Test::Unit::TestCase
                  words.scan(longtext))
   end
 
+  def test_scan_packed
+    Groonga::Context.default_options = {:encoding => "utf-8"}
+    words = Groonga::PatriciaTrie.create(:key_type => "ShortText",
+                                         :key_normalize => true)
+    words.add("リンク")
+    arupaka = words.add("アルパカ")
+    adventure_of_link = words.add('リンクの冒険')
+    words.add('冒険')
+    muteki = words.add('ＭＵＴＥＫＩ')
+    ids, offsets, lengths =
+      words.scan_packed('muTEki リンクの冒険 ミリバール アルパカ')
+    assert_equal([
+                   [muteki.id, adventure_of_link.id, arupaka.id],
+                   [0, 7, 42],
+                   [6, 18, 12],
+                 ],
+                 [
+                   ids.unpack("L*"),
+                   offsets.unpack("L*"),
+                   lengths.unpack("L*"),
+                 ])
+  end
+
   def test_scan_no_database
     Groonga::Context.open(encoding: "utf-8") do |context|
       Groonga::PatriciaTrie.create(context: context,
@@ -216,6 +239,39 @@ class PatriciaTrieTest < Test::Unit::TestCase
                  actual)
   end
 
+  def test_tag_keys_with_tags
+    Groonga::Context.default_options = {:encoding => "utf-8"}
+    words = Groonga::PatriciaTrie.create(:key_type => "ShortText",
+                                         :key_normalize => true)
+    words.add('リンク')
+    adventure_of_link = words.add('リンクの冒険')
+    words.add('冒険')
+    muteki = words.add('ＭＵＴＥＫＩ')
+
+    text = 'muTEki リンクの冒険 マッチしない'
+    actual = words.tag_keys(text,
+                            :open_tag => "<a id=\"%{id}\">",
+                            :close_tag => "</a>")
+    assert_equal("<a id=\"#{muteki.id}\">muTEki</a> " +
+                 "<a id=\"#{adventure_of_link.id}\">リンクの冒険</a> " +
+                 "マッチしない",
+                 actual)
+  end
+
+  def test_tag_keys_with_tags_multiple_ids
+    Groonga::Context.default_options = {:encoding => "utf-8"}
+    words = Groonga::PatriciaTrie.create(:key_type => "ShortText",
+                                         :key_normalize => true)
+    muteki = words.add('ＭＵＴＥＫＩ')
+
+    actual = words.tag_keys("muTEki です",
+                            :open_tag => "<a id=\"%{id}\" href=\"/%{id}\">",
+                            :close_tag => "</a>")
+    assert_equal("<a id=\"#{muteki.id}\" href=\"/#{muteki.id}\">" +
+                 "muTEki</a> です",
+                 actual)
+  end
+
   def test_tag_keys_other_text_handler
     Groonga::Context.default_options = {:encoding => "utf-8"}
     words = Groonga::PatriciaTrie.create(:key_type => "ShortText",
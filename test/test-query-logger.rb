@@ -1,4 +1,4 @@
-# Copyright (C) 2015-2019  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2015-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -70,6 +70,12 @@ class QueryLoggerTest < Test::Unit::TestCase
                    parse(:command))
     end
 
+    test "String with |" do
+      assert_equal(Groonga::QueryLogger::Flags::COMMAND |
+                   Groonga::QueryLogger::Flags::CACHE,
+                   parse("command|cache"))
+    end
+
     test "Array" do
       assert_equal(Groonga::QueryLogger::Flags::COMMAND |
                    Groonga::QueryLogger::Flags::RESULT_CODE,
@@ -89,6 +95,18 @@ class QueryLoggerTest < Test::Unit::TestCase
     end
   end
 
+  sub_test_case ".register" do
+    test ":flags" do
+      flags = []
+      Groonga::QueryLogger.register(:flags => "command|cache") do |*args|
+        flags << args[1]
+      end
+      context.execute_command("status")
+      assert_equal([Groonga::QueryLogger::Flags::COMMAND],
+                   flags.uniq)
+    end
+  end
+
   sub_test_case ".log" do
     test "no options" do
       messages = []
@@ -141,6 +159,86 @@ class QueryLoggerTest < Test::Unit::TestCase
     end
   end
 
+  sub_test_case ".statistics" do
+    setup do
+      Groonga::QueryLogger.reset_statistics
+    end
+
+    teardown do
+      Groonga::QueryLogger.unregister
+      Groonga::QueryLogger.reset_statistics
+    end
+
+    def log_command
+      Groonga::QueryLogger.log("select Users", :mark => ">")
+      Groonga::QueryLogger.log("filter(2)", :mark => ":")
+      Groonga::QueryLogger.log("sort(2)", :mark => ":")
+      Groonga::QueryLogger.log("rc=0", :mark => "<")
+    end
+
+    test "stages" do
+      Groonga::QueryLogger.register(nil, :statistics => true)
+      2.times do
+        log_command
+      end
+      statistics = Groonga::QueryLogger.statistics
+      n_samples = {}
+      statistics.each do |command, stages|
+        stages.each do |stage, stage_statistics|
+          n_samples["#{command}.#{stage}"] = stage_statistics[:n_samples]
+        end
+      end
+      assert_equal([
+                     {
+                       "select.filter" => 2,
+                       "select.sort" => 2,
+                       "select.total" => 2,
+                     },
+                     [:n_samples, :min, :max, :mean, :p50, :p90, :p99, :p999],
+                   ],
+                   [
+                     n_samples,
+                     statistics["select"]["total"].keys,
+                   ])
+    end
+
+    test "logger doesn't receive entries only for statistics" do
+      messages = []
+      Groonga::QueryLogger.register(:statistics => true,
+                                    :flags => "cache") do |*args|
+        messages << args.last
+      end
+      Groonga::QueryLogger.log("command", :flags => "command")
+      Groonga::QueryLogger.log("cache", :flags => "cache")
+      Groonga::QueryLogger.log("none")
+      assert_equal(["cache", "none"], messages)
+    end
+
+    test "options with block" do
+      messages = []
+      Groonga::QueryLogger.register(:statistics => true) do |*args|
+        messages << args.last
+      end
+      log_command
+      assert_equal([
+                     ["select Users", "filter(2)", "sort(2)", "rc=0"],
+                     ["select"],
+                   ],
+                   [
+                     messages,
+                     Groonga::QueryLogger.statistics.keys,
+                   ])
+    end
+
+    test ":sampling_rate" do
+      Groonga::QueryLogger.register(nil,
+                                    :statistics => true,
+                                    :sampling_rate => 0.0)
+      log_command
+      assert_equal({}, Groonga::QueryLogger.statistics)
+    end
+  end
+
   def test_rotate_threshold_size
     Groonga::QueryLogger.unregister
     Groonga::QueryLogger.path = @query_log_path.to_s
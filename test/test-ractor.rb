@@ -1,4 +1,4 @@
-# Copyright (C) 2021  Sutou Kouhei <kou@clear-code.com>
+# Copyright (C) 2021-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -65,4 +65,38 @@ class RactorTest < Test::Unit::TestCase
     assert_equal(["Groonga is fast!", "Rroonga is the Groonga bindings"],
                  result)
   end
+
+  test "SearchPool" do
+    pool = Groonga::SearchPool.new(@database_path.to_s,
+                                   n_workers: 2,
+                                   encoding: :utf8)
+    begin
+      results = pool.search_many([
+        [
+          "Comments",
+          "content:@Groonga",
+          {columns: ["content"], sort_keys: [["_id", "descending"]]},
+        ],
+        ["Comments", "content:@Hello", {columns: ["_id", "content"]}],
+        ["Comments", nil, {columns: ["_id"], limit: 2}],
+      ])
+    ensure
+      pool.close
+    end
+    assert_equal([
+                   [
+                     [
+                       ["Rroonga is the Groonga bindings"],
+                       ["Groonga is fast!"],
+                     ],
+                     [[1, "Hello World"]],
+                     [[1], [2]],
+                   ],
+                   true,
+                 ],
+                 [
+                   results,
+                   Ractor.shareable?(results),
+                 ])
+  end
 end
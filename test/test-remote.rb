@@ -122,6 +122,29 @@ class RemoteTest < Test::Unit::TestCase
     assert_equal(expected.sort, values.keys.sort)
   end
 
+  def test_pipeline
+    _context = Groonga::Context.new(release_gvl: true)
+    _context.connect(:host => @host, :port => @port)
+    assert_true(_context.connected?)
+    responses = _context.pipeline do |pipeline|
+      pipeline.execute("table_create",
+                       :name => "Users",
+                       :flags => "TABLE_HASH_KEY",
+                       :key_type => "ShortText")
+      pipeline.execute("load",
+                       :table => "Users",
+                       :values => [{"_key" => "alice"}].to_json)
+      pipeline.execute("select", :table => "Users")
+      assert_equal(3, pipeline.n_pending_requests)
+    end
+    assert_equal([true, 1, 1],
+                 [
+                   responses[0].body,
+                   responses[1].body,
+                   responses[2].n_hits,
+                 ])
+  end
+
   def test_invalid_select
     context.connect(:host => @host, :port => @port)
 
@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2009-2010  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -41,6 +41,47 @@ class SnippetTest < Test::Unit::TestCase
                  snippet.execute(text))
   end
 
+  def test_execute_for
+    entries = Groonga::Array.create(:name => "Entries")
+    entries.define_column("content", "Text")
+    with_text = entries.add(:content => text)
+    empty = entries.add(:content => "")
+    snippet = Groonga::Snippet.new
+    snippet.add_keyword("検索", :open_tag => "[[", :close_tag => "]]")
+    expected = [snippet.execute(text), []]
+    assert_equal([
+                   expected,
+                   expected.reverse,
+                 ],
+                 [
+                   snippet.execute_for(entries, "content"),
+                   snippet.execute_for([empty, with_text.id], :content),
+                 ])
+  end
+
+  def test_execute_for_ids
+    entries = Groonga::Array.create(:name => "Entries")
+    entries.define_column("content", "Text")
+    record = entries.add(:content => text)
+    snippet = Groonga::Snippet.new
+    snippet.add_keyword("検索", :open_tag => "[[", :close_tag => "]]")
+    assert_equal([snippet.execute(text)],
+                 snippet.execute_for([record.id], "content",
+                                     :table => entries))
+  end
+
+  def test_execute_for_ids_without_table
+    entries = Groonga::Array.create(:name => "Entries")
+    entries.define_column("content", "Text")
+    record = entries.add(:content => text)
+    snippet = Groonga::Snippet.new
+    snippet.add_keyword("検索")
+    message = ":table is required for record IDs: #{record.id}"
+    assert_raise(ArgumentError.new(message)) do
+      snippet.execute_for([record.id], "content")
+    end
+  end
+
   def test_execute_with_nil
     snippet = Groonga::Snippet.new
     snippet.add_keyword("検索", :open_tag => "[[", :close_tag => "]]")
@@ -202,4 +202,90 @@ class TableArrowTest < Test::Unit::TestCase
     assert_equal(expected,
                  destination.collect(&:attributes))
   end
+
+  sub_test_case "#dump_arrow partitioned" do
+    setup
+    def setup_tables
+      Groonga::Schema.define do |schema|
+        schema.create_table("Source") do |table|
+          table.int32("data")
+        end
+
+        schema.create_table("Destination") do |table|
+        end
+      end
+
+      @source = Groonga["Source"]
+      @destination = Groonga["Destination"]
+      10.times do |i|
+        @source.add(:data => i)
+      end
+    end
+
+    def test_offset_limit
+      open_temporary_file(".arrow") do |tempfile|
+        @source.dump_arrow(tempfile.path, offset: 2, limit: 3)
+        @destination.load_arrow(tempfile.path)
+      end
+      assert_equal([2, 3, 4],
+                   @destination.collect(&:data))
+    end
+
+    def test_condition
+      result = @source.select do |record|
+        record.data >= 7
+      end
+      open_temporary_file(".arrow") do |tempfile|
+        @source.dump_arrow(tempfile.path, condition: result)
+        @destination.load_arrow(tempfile.path)
+      end
+      assert_equal([7, 8, 9],
+                   @destination.collect(&:data))
+    end
+
+    def test_n_workers
+      path = @tmp_dir + "source.arrow"
+      @source.dump_arrow(path.to_s, n_workers: 3)
+      3.times do |i|
+        @destination.load_arrow((@tmp_dir + "source-#{i}.arrow").to_s)
+      end
+      assert_equal((0...10).to_a,
+                   @destination.collect(&:data))
+    end
+  end
+
+  sub_test_case "#load_arrow_stream" do
+    setup
+    def setup_arrow_stream
+      begin
+        require "arrow"
+      rescue LoadError
+        omit("red-arrow is required")
+      end
+
+      Groonga::Schema.define do |schema|
+        schema.create_table("Destination") do |table|
+          table.int32("data")
+        end
+      end
+      @destination = Groonga["Destination"]
+
+      arrow_table = Arrow::Table.new("data" => Arrow::Int32Array.new([1, 2, 3]))
+      buffer = Arrow::ResizableBuffer.new(0)
+      arrow_table.save(buffer, format: :stream)
+      @stream = buffer.data.to_s
+    end
+
+    def test_string
+      @destination.load_arrow_stream(@stream)
+      assert_equal([1, 2, 3],
+                   @destination.collect(&:data))
+    end
+
+    def test_io
+      @destination.load_arrow_stream(StringIO.new(@stream))
+      assert_equal([1, 2, 3],
+                   @destination.collect(&:data))
+    end
+  end
 end
@@ -1,6 +1,6 @@
 # -*- coding: utf-8 -*-
 #
-# Copyright (C) 2011-2015  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2011-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -25,6 +25,17 @@ class TableDumperTest < Test::Unit::TestCase
     Groonga::TableDumper.new(context[table_name], options).dump
   end
 
+  class RubyTableDumper < Groonga::TableDumper
+    private
+    def dump_records_native(columns, order_by, limit)
+      false
+    end
+  end
+
+  def dump_by_ruby(table_name, options={})
+    RubyTableDumper.new(context[table_name], options).dump
+  end
+
   def users
     context["Users"]
   end
@@ -232,6 +243,17 @@ load --table Users
 EOS
       end
 
+      def test_escape
+        users.add(:name => "\"mori\"\\\t\n\u0001/")
+        assert_equal(<<-'EOS', dump("Users"))
+load --table Users
+[
+["_id","name"],
+[1,"\"mori\"\\\t\n\u0001/"]
+]
+EOS
+      end
+
       def test_invalid_utf8
         need_encoding
 
@@ -250,6 +272,35 @@ EOS
       end
     end
 
+    class KeyedScalarTest < self
+      def setup
+        Groonga::Schema.define do |schema|
+          schema.create_table("Users",
+                              :type => :hash,
+                              :key_type => "ShortText") do |table|
+            table.text("name")
+          end
+        end
+      end
+
+      def test_invalid_utf8
+        need_encoding
+
+        users.add("mori", :name => "森\xff大二郎")
+        error_output = StringIO.new
+        assert_equal(<<-EOS, dump("Users", :error_output => error_output))
+load --table Users
+[
+["_key","name"],
+["mori","森大二郎"]
+]
+EOS
+        assert_equal("warning: ignore invalid encoding character: " +
+                       "<Users[mori].name>: <0xff>: before: <森>\n",
+                     error_output.string)
+      end
+    end
+
     class VectorTest < self
       def setup
         Groonga::Schema.define do |schema|
@@ -593,4 +644,94 @@ load --table Products
       COMMAND
     end
   end
+
+  class NativeTest < self
+    def setup
+      Groonga::Schema.define do |schema|
+        schema.create_table("Tags",
+                            :type => :hash,
+                            :key_type => "ShortText") do |table|
+        end
+        schema.create_table("Comments") do |table|
+        end
+        schema.create_table("Posts") do |table|
+          table.short_text("titles", :type => :vector)
+          table.int32("ranks", :type => :vector)
+          table.reference("tag", "Tags")
+          table.reference("tags", "Tags", :type => :vector)
+          table.reference("comment", "Comments")
+          table.time("created_at")
+          table.float("score")
+        end
+      end
+    end
+
+    def assert_same_dump(expected)
+      assert_equal([expected, expected],
+                   [dump("Posts"), dump_by_ruby("Posts")])
+    end
+
+    def test_vector
+      posts.add(:titles => ["Groonga", "Rroonga"],
+                :ranks => [1, -2])
+      posts.add(:titles => [],
+                :ranks => [])
+      assert_same_dump(<<-EOS)
+load --table Posts
+[
+["_id","comment","created_at","ranks","score","tag","tags","titles"],
+[1,"",0.0,[1,-2],0.0,"",[],["Groonga","Rroonga"]],
+[2,"",0.0,[],0.0,"",[],[]]
+]
+EOS
+    end
+
+    def test_reference
+      comments = context["Comments"]
+      comment = comments.add
+      posts.add(:tag => "groonga",
+                :tags => ["groonga", "rroonga"],
+                :comment => comment)
+      posts.add(:tag => nil,
+                :comment => nil)
+      assert_same_dump(<<-EOS)
+load --table Posts
+[
+["_id","comment","created_at","ranks","score","tag","tags","titles"],
+[1,1,0.0,[],0.0,"groonga",["groonga","rroonga"],[]],
+[2,"",0.0,[],0.0,"",[],[]]
+]
+EOS
+    end
+
+    def test_time
+      posts.add(:created_at => Time.at(1268034720, 123456789, :nsec))
+      # Groonga stores time in microseconds.
+      created_at = Time.at(1268034720, 123456, :usec).to_f
+      assert_same_dump(<<-EOS)
+load --table Posts
+[
+["_id","comment","created_at","ranks","score","tag","tags","titles"],
+[1,"",#{created_at},[],0.0,"",[],[]]
+]
+EOS
+    end
+
+    def test_float
+      posts.add(:score => 0.1)
+      posts.add(:score => -2.5)
+      posts.add(:score => 1.0e+20)
+      posts.add(:score => 1.0e-5)
+      assert_same_dump(<<-EOS)
+load --table Posts
+[
+["_id","comment","created_at","ranks","score","tag","tags","titles"],
+[1,"",0.0,[],0.1,"",[],[]],
+[2,"",0.0,[],-2.5,"",[],[]],
+[3,"",0.0,[],1.0e+20,"",[],[]],
+[4,"",0.0,[],1.0e-05,"",[],[]]
+]
+EOS
+    end
+  end
 end
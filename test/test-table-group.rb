@@ -1,5 +1,5 @@
 # Copyright (C) 2015  Masafumi Yokoyama <yokoyama@clear-code.com>
-# Copyright (C) 2009-2013  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2009-2025  Sutou Kouhei <kou@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
 # modify it under the terms of the GNU Lesser General Public
@@ -175,6 +175,21 @@ class TableGroupTest < Test::Unit::TestCase
                    grouped_records)
     end
 
+    def test_release_gvl
+      context.release_gvl = true
+      grouped_records = @comments.group("bookmark").collect do |record|
+        [
+          record.n_sub_records,
+          record.key.key,
+        ]
+      end
+      assert_equal([
+                     [2, "http://groonga.org/"],
+                     [1, "http://ruby-lang.org/"],
+                   ],
+                   grouped_records)
+    end
+
     def test_array
       grouped_records = @comments.group(["bookmark"]).collect do |record|
         bookmark = record.key
@@ -364,5 +379,55 @@ class TableGroupTest < Test::Unit::TestCase
                    ],
                    grouped_data)
     end
+
+    def test_aggregate
+      result = @memos.aggregate("tag",
+                                :aggregates => {
+                                  "priority" => [:max, :min, :sum, :average],
+                                })
+      assert_equal([
+                     ["Groonga", "Mroonga", "Rroonga"],
+                     [3, 3, 3],
+                     [40.0, 50.0, 25.0],
+                     [10.0, 10.0, -25.0],
+                     [70.0, 85.0, 0.0],
+                     [23.333, 28.333, 0.0],
+                   ],
+                   [
+                     result["tag"].collect(&:key),
+                     result.n_records,
+                     result["priority", :max],
+                     result["priority", :min],
+                     result["priority", :sum],
+                     result["priority", :average].collect {|v| v.round(3)},
+                   ])
+    end
+
+    def test_aggregate_n_workers
+      result = @memos.aggregate("tag",
+                                :aggregates => {"priority" => [:sum, :count]},
+                                :n_workers => 2)
+      assert_equal([
+                     {
+                       "tag" => @groonga,
+                       "n_records" => 3,
+                       "priority.sum" => 70.0,
+                       "priority.count" => 3,
+                     },
+                     {
+                       "tag" => @mroonga,
+                       "n_records" => 3,
+                       "priority.sum" => 85.0,
+                       "priority.count" => 3,
+                     },
+                     {
+                       "tag" => @rroonga,
+                       "n_records" => 3,
+                       "priority.sum" => 0.0,
+                       "priority.count" => 3,
+                     },
+                   ],
+                   result.to_a)
+    end
   end
 end
@@ -1,4 +1,4 @@
-# Copyright (C) 2013-2014  Kouhei Sutou <kou@clear-code.com>
+# Copyright (C) 2013-2025  Sutou Kouhei <kou@clear-code.com>
 # Copyright (C) 2016  Masafumi Yokoyama <yokoyama@clear-code.com>
 #
 # This library is free software; you can redistribute it and/or
@@ -197,6 +197,46 @@ class TableKeySupportTest < Test::Unit::TestCase
     end
   end
 
+  class TokenizeManyTest < self
+    setup
+    def setup_lexicon
+      Groonga::Schema.create_table("Terms",
+                                   :type => :patricia_trie,
+                                   :key_type => "ShortText",
+                                   :default_tokenizer => "TokenBigram",
+                                   :normalizer => "NormalizerAuto")
+      @lexicon = Groonga["Terms"]
+    end
+
+    def test_ids
+      strings = ["Hello World!", "", "Hello"]
+      ids, offsets = @lexicon.tokenize_many(strings)
+      ids = ids.unpack("L*")
+      offsets = offsets.unpack("L*")
+      tokens = offsets.each_cons(2).collect do |start, finish|
+        ids[start...finish].collect {|id| @lexicon[id].key}
+      end
+      assert_equal([
+                     ["hello", "world", "!"],
+                     [],
+                     ["hello"],
+                   ],
+                   tokens)
+    end
+
+    def test_records
+      @lexicon.tokenize("Hello groonga!")
+      tokens = @lexicon.tokenize_many(["Hello World!", "groonga"],
+                                      :add => false,
+                                      :as => :records)
+      assert_equal([
+                     ["hello", "!"],
+                     ["groonga"],
+                   ],
+                   tokens.collect {|records| records.collect(&:key)})
+    end
+  end
+
   class ReindexTest < self
     def test_patricia_trie
       Groonga::Schema.define do |schema|
@@ -71,6 +71,86 @@ class TableSelectTest < Test::Unit::TestCase
     assert_equal_select_result([@comment1, @comment2], @result)
   end
 
+  def test_query_release_gvl
+    context.release_gvl = true
+    @result = @comments.select("content:@Hello")
+    assert_equal_select_result([@comment1, @comment2], @result)
+  end
+
+  def test_prepare_select
+    prepared = @comments.prepare_select("content @ keyword",
+                                        :variables => {"keyword" => ""})
+    hello_result = prepared.execute("keyword" => "Hello")
+    test_result = prepared.execute(:keyword => "test")
+    assert_equal([
+                   [@comment1, @comment2],
+                   [@comment3],
+                 ],
+                 [
+                   hello_result.collect(&:key),
+                   test_result.collect(&:key),
+                 ])
+  end
+
+  def test_prepare_select_unknown_variable
+    prepared = @comments.prepare_select("content @ keyword",
+                                        :variables => ["keyword"])
+    message = "unknown variable: <nonexistent>: available: [\"keyword\"]"
+    assert_raise(ArgumentError.new(message)) do
+      prepared.execute(:nonexistent => "Hello")
+    end
+  end
+
+  def test_query_expression_cache
+    cache = Groonga::ExpressionCache.new(1)
+    context.expression_cache = cache
+    result1 = @comments.select("content:@Hello")
+    result2 = @comments.select("content:@Hello")
+    @result = @comments.select("content:@World")
+    assert_equal([
+                   true,
+                   [1, 1, 2],
+                   1,
+                 ],
+                 [
+                   result1.expression.equal?(result2.expression),
+                   [cache.n_hits, cache.size, cache.n_misses],
+                   @result.size,
+                 ])
+  end
+
+  def test_query_expression_cache_mutated_query
+    cache = Groonga::ExpressionCache.new(10)
+    context.expression_cache = cache
+    query = +"content:@Hello"
+    @comments.select(query)
+    query.replace("content:@World")
+    @result = @comments.select("content:@Hello")
+    assert_equal([
+                   [1, 1],
+                   [@comment1, @comment2],
+                 ],
+                 [
+                   [cache.n_hits, cache.n_misses],
+                   @result.collect(&:key),
+                 ])
+  end
+
+  def test_query_expression_cache_temporary_table
+    cache = Groonga::ExpressionCache.new(10)
+    context.expression_cache = cache
+    hello_comments = @comments.select("content:@Hello")
+    @result = hello_comments.select("content:@World")
+    assert_equal([
+                   [0, 1, 1],
+                   [@comment2],
+                 ],
+                 [
+                   [cache.n_hits, cache.n_misses, cache.size],
+                   @result.collect {|record| record.key.key},
+                 ])
+  end
+
   def test_query_with_parser
     @result = @comments.select("content @ \"Hello\"", :syntax => :script)
     assert_equal_select_result([@comment1, @comment2], @result)
@@ -223,6 +223,165 @@ class TableTest < Test::Unit::TestCase
                  bookmarks.columns.collect {|column| column.name}.sort)
   end
 
+  sub_test_case "#load_rows" do
+    setup
+    def setup_users
+      @users = Groonga::Hash.create(:name => "Users",
+                                    :key_type => "ShortText")
+      @users.define_column("name", "ShortText")
+      @users.define_column("age", "UInt32")
+    end
+
+    def test_key
+      n_loaded = @users.load_rows(["_key", "name", :age],
+                                  [
+                                    ["alice", "Alice", 29],
+                                    ["bob", "Bob", 41],
+                                  ])
+      assert_equal([
+                     2,
+                     [
+                       ["alice", "Alice", 29],
+                       ["bob", "Bob", 41],
+                     ],
+                   ],
+                   [
+                     n_loaded,
+                     @users.collect {|user| [user._key, user.name, user.age]},
+                   ])
+    end
+
+    def test_no_key
+      comments = Groonga::Array.create(:name => "Comments")
+      comments.define_column("content", "Text")
+      comments.load_rows(["content"], [["Hello"], ["World"]])
+      assert_equal(["Hello", "World"],
+                   comments.collect(&:content))
+    end
+
+    def test_errors
+      errors = []
+      n_loaded = @users.load_rows(["_key", "age"],
+                                  [
+                                    ["alice", 29],
+                                    [nil, 41],
+                                    ["chris", 12],
+                                  ],
+                                  :errors => errors)
+      assert_equal([
+                     2,
+                     [1],
+                     ["alice", "chris"],
+                   ],
+                   [
+                     n_loaded,
+                     errors.collect(&:first),
+                     @users.collect(&:_key),
+                   ])
+    end
+
+    def test_nonexistent_column
+      assert_raise(Groonga::NoSuchColumn) do
+        @users.load_rows(["_key", "nonexistent"], [["alice", 1]])
+      end
+    end
+  end
+
+  def test_load_records
+    users = Groonga::Hash.create(:name => "Users",
+                                 :key_type => "ShortText")
+    users.define_column("name", "ShortText")
+    users.define_column("age", "UInt32")
+    users.load_records([
+                         {"_key" => "alice", "age" => 29},
+                         {:_key => "bob", :name => "Bob"},
+                       ])
+    assert_equal([
+                   ["alice", nil, 29],
+                   ["bob", "Bob", 0],
+                 ],
+                 users.collect {|user| [user._key, user.name, user.age]})
+  end
+
+  def test_column_arrays
+    users = Groonga::Hash.create(:name => "Users",
+                                 :key_type => "ShortText")
+    users.define_column("age", "Int32")
+    users.define_column("nick", "ShortText")
+    users.add("alice", :age => 16, :nick => "Ali")
+    users.add("bob", :age => 29, :nick => "Bobby")
+
+    assert_equal([
+                   ["alice", "bob"],
+                   [16, 29],
+                   ["Ali", "Bobby"],
+                 ],
+                 users.column_arrays(["_key", "age", :nick]))
+  end
+
+  def test_column_arrays_result
+    users = Groonga::Hash.create(:name => "Users",
+                                 :key_type => "ShortText")
+    users.define_column("age", "Int32")
+    users.add("alice", :age => 16)
+    users.add("bob", :age => 29)
+    users.add("chris", :age => 32)
+
+    adults = users.select do |record|
+      record.age >= 20
+    end
+    assert_equal([
+                   ["bob", "chris"],
+                   [29, 32],
+                 ],
+                 adults.column_arrays(["_key", "age"]))
+  end
+
+  sub_test_case "#each_row" do
+    setup
+    def setup_users
+      @users = Groonga::Hash.create(:name => "Users",
+                                    :key_type => "ShortText")
+      @users.define_column("age", "Int32")
+      @users.define_column("tags", "ShortText", :type => :vector)
+      @users.add("alice", :age => 16, :tags => ["a", "b"])
+      @users.add("bob", :age => 29, :tags => [])
+      @users.add("chris", :age => 32, :tags => ["c"])
+    end
+
+    test "columns" do
+      rows = []
+      @users.each_row(:columns => ["_key", :age, "tags"]) do |row|
+        rows << row
+      end
+      assert_equal([
+                     ["alice", 16, ["a", "b"]],
+                     ["bob", 29, []],
+                     ["chris", 32, ["c"]],
+                   ],
+                   rows)
+    end
+
+    test "cursor options" do
+      assert_equal([["chris"], ["bob"]],
+                   @users.each_row(:columns => ["_key"],
+                                   :order => :desc,
+                                   :order_by => :id,
+                                   :limit => 2).to_a)
+    end
+
+    test "reuse" do
+      row_ids = []
+      ages = []
+      @users.each_row(:columns => ["age"], :reuse => true) do |row|
+        row_ids << row.object_id
+        ages << row[0]
+      end
+      assert_equal([[16, 29, 32], 1],
+                   [ages, row_ids.uniq.size])
+    end
+  end
+
   def test_column_by_symbol
     bookmarks_path = @tables_dir + "bookmarks"
     bookmarks = Groonga::Array.create(:name => "Bookmarks",
@@ -400,6 +559,62 @@ class TableTest < Test::Unit::TestCase
                  results.collect {|record| record["id"]})
   end
 
+  def test_sort_release_gvl
+    context.release_gvl = true
+    bookmarks = create_bookmarks
+    add_shuffled_ids(bookmarks)
+
+    results = bookmarks.sort([{:key => "id", :order => :descending}],
+                             :limit => 20)
+    assert_equal((180..199).to_a.reverse,
+                 results.collect {|record| record["id"]})
+  end
+
+  def test_sort_n_workers
+    bookmarks = create_bookmarks
+    add_shuffled_ids(bookmarks)
+
+    results = bookmarks.sort([{:key => "id", :order => :descending}],
+                             :offset => 5,
+                             :limit => 20,
+                             :n_workers => 3)
+    assert_equal((175..194).to_a.reverse,
+                 results.collect {|record| record["id"]})
+  end
+
+  def test_sort_n_workers_select_result
+    bookmarks = create_bookmarks
+    add_shuffled_ids(bookmarks)
+
+    selected_bookmarks = bookmarks.select do |record|
+      record.id >= 150
+    end
+    results = selected_bookmarks.sort([["id", :descending]],
+                                      :limit => 10,
+                                      :n_workers => 2)
+    assert_equal((190..199).to_a.reverse,
+                 results.collect {|record| record["id"]})
+  end
+
+  def test_sort_n_workers_group_result
+    users = Groonga::Hash.create(:name => "Users",
+                                 :key_type => "ShortText")
+    bookmarks = Groonga::Array.create(:name => "Bookmarks")
+    bookmarks.define_column("user", users)
+    ["alice", "bob", "alice", "chris", "bob", "alice"].each do |user|
+      bookmarks.add(:user => user)
+    end
+
+    grouped_bookmarks = bookmarks.group("user")
+    results = grouped_bookmarks.sort([["_nsubrecs", :descending]],
+                                     :limit => 2,
+                                     :n_workers => 2)
+    assert_equal([["alice", 3], ["bob", 2]],
+                 results.collect {|record|
+                   [record.value.key.key, record.value.n_sub_records]
+                 })
+  end
+
   def test_sort_simple
     bookmarks = create_bookmarks
     add_shuffled_ids(bookmarks)